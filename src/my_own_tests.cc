@@ -1,7 +1,30 @@
 #include <gtest/gtest.h>
 #include <math.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <sstream>
+
+#include "s21_distributed.h"
+#include "s21_lu.h"
+#include "s21_maintained_inverse.h"
+#include "s21_qr.h"
 #include "s21_matrix_oop.h"
+#include "s21_structured_matrix.h"
+#include "s21_thread_pool.h"
+#include "s21_vector.h"
+
+double MaxAbsDiff(const S21Matrix& a, const S21Matrix& b) {
+  double result = 0;
+  for (int i = 0; i < a.GetRows(); i++) {
+    for (int j = 0; j < a.GetCols(); j++) {
+      result = std::max(result, std::fabs(a(i, j) - b(i, j)));
+    }
+  }
+  return result;
+}
 
 TEST(Conctructor, defaultConstructor) {
   S21Matrix matrix;
@@ -96,6 +119,155 @@ TEST(Setter, SetMatrix) {
   EXPECT_ANY_THROW(matrix.SetMatrix(2, -1, 0));
 }
 
+TEST(Capacity, SetRows_growth) {
+  S21Matrix matrix(1, 2);
+  matrix(0, 0) = 1;
+  for (int i = 2; i <= 100; i++) {
+    matrix.SetRows(i);
+    EXPECT_GE(matrix.GetRowsCapacity(), i);
+    EXPECT_DOUBLE_EQ(matrix(i - 1, 1), 0);
+  }
+  EXPECT_DOUBLE_EQ(matrix(0, 0), 1);
+  EXPECT_LT(matrix.GetRowsCapacity(), 200);
+}
+
+TEST(Capacity, Shrink_and_grow) {
+  S21Matrix matrix(3, 3);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      matrix(i, j) = 5;
+    }
+  }
+  matrix.SetCols(1);
+  matrix.SetRows(1);
+  EXPECT_EQ(matrix.GetRowsCapacity(), 3);
+  EXPECT_EQ(matrix.GetColsCapacity(), 3);
+  matrix.SetCols(3);
+  matrix.SetRows(3);
+  EXPECT_DOUBLE_EQ(matrix(0, 0), 5);
+  EXPECT_DOUBLE_EQ(matrix(0, 2), 0);
+  EXPECT_DOUBLE_EQ(matrix(2, 0), 0);
+}
+
+TEST(Capacity, Reserve_ShrinkToFit) {
+  S21Matrix matrix(2, 2);
+  matrix(1, 1) = 3;
+  matrix.Reserve(10, 8);
+  EXPECT_EQ(matrix.GetRowsCapacity(), 10);
+  EXPECT_EQ(matrix.GetColsCapacity(), 8);
+  EXPECT_EQ(matrix.GetRows(), 2);
+  EXPECT_DOUBLE_EQ(matrix(1, 1), 3);
+  matrix.ShrinkToFit();
+  EXPECT_EQ(matrix.GetRowsCapacity(), 2);
+  EXPECT_EQ(matrix.GetColsCapacity(), 2);
+  EXPECT_DOUBLE_EQ(matrix(1, 1), 3);
+  EXPECT_ANY_THROW(matrix.Reserve(-1, 2));
+}
+
+TEST(Capacity, AppendRow_RemoveRow) {
+  S21Matrix matrix;
+  S21Matrix row(1, 3);
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 3; j++) {
+      row(0, j) = i * 3 + j;
+    }
+    matrix.AppendRow(row);
+  }
+  EXPECT_EQ(matrix.GetRows(), 5);
+  EXPECT_EQ(matrix.GetCols(), 3);
+  EXPECT_DOUBLE_EQ(matrix(4, 2), 14);
+  matrix.RemoveRow(1);
+  EXPECT_EQ(matrix.GetRows(), 4);
+  EXPECT_DOUBLE_EQ(matrix(1, 0), 6);
+  EXPECT_DOUBLE_EQ(matrix(3, 2), 14);
+  EXPECT_ANY_THROW(matrix.RemoveRow(4));
+  EXPECT_ANY_THROW(matrix.AppendRow(S21Matrix(1, 2)));
+}
+
+TEST(AllocPolicy, HugePages_and_numa) {
+  S21AllocPolicy policy;
+  policy.huge_pages = S21HugePages::kTransparent;
+  policy.numa = S21NumaPolicy::kInterleave;
+  policy.parallel_first_touch = true;
+  S21Matrix matrix(1024, 600);
+  matrix(1023, 599) = 7;
+  matrix.SetAllocPolicy(policy);
+  EXPECT_EQ(matrix.GetAllocPolicy().huge_pages, S21HugePages::kTransparent);
+  EXPECT_DOUBLE_EQ(matrix(1023, 599), 7);
+  EXPECT_DOUBLE_EQ(matrix(512, 300), 0);
+  matrix.SetRows(2048);
+  EXPECT_DOUBLE_EQ(matrix(1023, 599), 7);
+  EXPECT_DOUBLE_EQ(matrix(2047, 599), 0);
+  S21Matrix copy(matrix);
+  EXPECT_EQ(copy.GetAllocPolicy().numa, S21NumaPolicy::kInterleave);
+  EXPECT_DOUBLE_EQ(copy(1023, 599), 7);
+}
+
+TEST(AllocPolicy, DefaultPolicy) {
+  S21AllocPolicy policy;
+  policy.huge_pages = S21HugePages::kExplicit;
+  policy.numa = S21NumaPolicy::kLocal;
+  S21Allocator::SetDefaultPolicy(policy);
+  S21Matrix matrix(600, 600);
+  S21Allocator::SetDefaultPolicy(S21AllocPolicy());
+  EXPECT_EQ(matrix.GetAllocPolicy().huge_pages, S21HugePages::kExplicit);
+  EXPECT_EQ(S21Matrix(2, 2).GetAllocPolicy().huge_pages, S21HugePages::kNone);
+  matrix(599, 599) = 1;
+  S21Matrix result = matrix + matrix;
+  EXPECT_DOUBLE_EQ(result(599, 599), 2);
+}
+
+TEST(CopyOnWrite, Copies_share_buffer) {
+  S21Matrix::SetCopyOnWrite(true);
+  // Маленькие матрицы хранятся в объекте и не разделяются
+  S21Matrix matrix(5, 5);
+  matrix(1, 1) = 5;
+  S21Matrix copy(matrix);
+  S21Matrix assigned;
+  assigned = matrix;
+  EXPECT_TRUE(matrix.IsShared());
+  EXPECT_TRUE(copy.IsShared());
+  EXPECT_DOUBLE_EQ(copy.GetMatrix(1, 1), 5);
+
+  copy(1, 1) = 7;
+  EXPECT_DOUBLE_EQ(copy.GetMatrix(1, 1), 7);
+  EXPECT_DOUBLE_EQ(matrix.GetMatrix(1, 1), 5);
+  EXPECT_FALSE(copy.IsShared());
+
+  assigned += matrix;
+  EXPECT_DOUBLE_EQ(assigned.GetMatrix(1, 1), 10);
+  EXPECT_DOUBLE_EQ(matrix.GetMatrix(1, 1), 5);
+  EXPECT_FALSE(matrix.IsShared());
+  S21Matrix::SetCopyOnWrite(false);
+}
+
+TEST(CopyOnWrite, Resize_and_factorize) {
+  S21Matrix::SetCopyOnWrite(true);
+  // Маленькие матрицы хранятся в объекте и не разделяются
+  S21Matrix matrix(5, 5);
+  for (int i = 0; i < 5; i++) {
+    matrix(i, i) = i + 1;
+  }
+  S21Matrix copy(matrix);
+  EXPECT_TRUE(copy.IsShared());
+  copy.SetRows(2);
+  copy.SetRows(5);
+  EXPECT_DOUBLE_EQ(copy.GetMatrix(4, 4), 0);
+  EXPECT_DOUBLE_EQ(matrix.GetMatrix(4, 4), 5);
+
+  S21Matrix other(matrix);
+  EXPECT_TRUE(other.IsShared());
+  EXPECT_DOUBLE_EQ(other.Determinant(), 120);
+  EXPECT_DOUBLE_EQ(matrix.GetMatrix(4, 4), 5);
+  other.MulNumber(2);
+  other.SetMatrix(1, 0, 0);
+  EXPECT_DOUBLE_EQ(matrix.GetMatrix(0, 0), 1);
+  EXPECT_DOUBLE_EQ(matrix.GetMatrix(1, 1), 2);
+  S21Matrix::SetCopyOnWrite(false);
+  S21Matrix deep(matrix);
+  EXPECT_FALSE(deep.IsShared());
+}
+
 TEST(Getter, GetMatrix) {
   S21Matrix matrix(3, 3);
   for (int i = 0; i < 3; i++) {
@@ -332,6 +504,171 @@ TEST(MulMatrix, MulMatrix_test_3) {
   EXPECT_ANY_THROW(matrix1.MulMatrix(matrix2));
 }
 
+TEST(Gemm, Gemm_test_1) {
+  S21Matrix a(2, 3);
+  S21Matrix b(3, 2);
+  S21Matrix c(2, 2);
+  int count = 1;
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 3; j++) {
+      a(i, j) = count;
+      b(j, i) = count;
+      count++;
+    }
+  }
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 2; j++) {
+      c(i, j) = 1;
+    }
+  }
+  S21Matrix expected = 0.5 * (a * b) + c * 2;
+  c.Gemm(0.5, a, b, 2);
+  EXPECT_TRUE(c == expected);
+}
+
+TEST(Gemm, Gemm_test_transpose) {
+  S21Matrix a(3, 2);
+  S21Matrix b(2, 3);
+  int count = 1;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 2; j++) {
+      a(i, j) = count;
+      b(j, i) = count * count;
+      count++;
+    }
+  }
+  S21Matrix at = a.Transpose();
+  S21Matrix bt = b.Transpose();
+  S21Matrix c(2, 2);
+  c.Gemm(1, a, b, 0, true, true);
+  EXPECT_TRUE(c == at * bt);
+  S21Matrix d(3, 3);
+  d.Gemm(1, a, bt, 0, false, true);
+  EXPECT_TRUE(d == a * b);
+  EXPECT_ANY_THROW(d.Gemm(1, a, b, 0, true, false));
+}
+
+TEST(Gemm, Gemm_test_alias) {
+  S21Matrix a(2, 2);
+  a(0, 0) = 1;
+  a(0, 1) = 2;
+  a(1, 0) = 3;
+  a(1, 1) = 4;
+  S21Matrix expected = a * a + a;
+  a.Gemm(1, a, a, 1);
+  EXPECT_TRUE(a == expected);
+}
+
+TEST(Gemm, Axpy_Scal_Ger) {
+  S21Matrix a(2, 3);
+  S21Matrix x(2, 1);
+  S21Matrix y(3, 1);
+  x(0, 0) = 1;
+  x(1, 0) = 2;
+  y(0, 0) = 3;
+  y(1, 0) = 4;
+  y(2, 0) = 5;
+  a.Ger(2, x, y);
+  EXPECT_DOUBLE_EQ(a(1, 2), 20);
+  EXPECT_DOUBLE_EQ(a(0, 0), 6);
+  S21Matrix b(a);
+  a.Axpy(-1, b);
+  EXPECT_DOUBLE_EQ(a(1, 2), 0);
+  b.Scal(0.5);
+  EXPECT_DOUBLE_EQ(b(1, 1), 8);
+  EXPECT_ANY_THROW(a.Axpy(1, x));
+  EXPECT_ANY_THROW(a.Ger(1, y, x));
+}
+
+TEST(Pow, Pow_test_1) {
+  S21Matrix matrix(2, 2);
+  matrix(0, 0) = 1;
+  matrix(0, 1) = 1;
+  matrix(1, 0) = 1;
+  S21Matrix fibonacci = matrix.Pow(30);
+  EXPECT_DOUBLE_EQ(fibonacci(0, 1), 832040);
+  EXPECT_DOUBLE_EQ(fibonacci(0, 0), 1346269);
+  EXPECT_TRUE(matrix.Pow(1) == matrix);
+  EXPECT_TRUE(matrix.Pow(5) == matrix * matrix * matrix * matrix * matrix);
+  EXPECT_DOUBLE_EQ(matrix.Pow(0)(1, 1), 1);
+  EXPECT_DOUBLE_EQ(matrix.Pow(0)(1, 0), 0);
+  EXPECT_LT(MaxAbsDiff(matrix.Pow(-3) * matrix.Pow(3), matrix.Pow(0)), 1e-12);
+  EXPECT_ANY_THROW(S21Matrix(2, 3).Pow(2));
+}
+
+TEST(Exp, Exp_test_1) {
+  S21Matrix matrix(3, 3);
+  matrix(0, 0) = 1;
+  matrix(1, 1) = -2;
+  matrix(2, 2) = 5;
+  S21Matrix result = matrix.Exp();
+  EXPECT_NEAR(result(0, 0) / std::exp(1), 1, 1e-13);
+  EXPECT_NEAR(result(1, 1) / std::exp(-2), 1, 1e-13);
+  EXPECT_NEAR(result(2, 2) / std::exp(5), 1, 1e-13);
+  EXPECT_NEAR(result(0, 1), 0, 1e-13);
+}
+
+TEST(Exp, Exp_test_rotation) {
+  S21Matrix matrix(2, 2);
+  matrix(0, 1) = -10;
+  matrix(1, 0) = 10;
+  S21Matrix result = matrix.Exp();
+  EXPECT_NEAR(result(0, 0), std::cos(10), 1e-12);
+  EXPECT_NEAR(result(0, 1), -std::sin(10), 1e-12);
+  EXPECT_NEAR(result(1, 0), std::sin(10), 1e-12);
+  S21Matrix zero(2, 2);
+  EXPECT_TRUE(zero.Exp() == zero.Pow(0));
+}
+
+TEST(Exp, Exp_not_finite) {
+  S21Matrix matrix(2, 2);
+  matrix(0, 0) = 1;
+  matrix(1, 1) = NAN;
+  EXPECT_THROW(matrix.Exp(), std::length_error);
+  matrix(1, 1) = -INFINITY;
+  EXPECT_THROW(matrix.Exp(), std::length_error);
+  // Конечные элементы, сумма которых переполняется
+  matrix(1, 1) = 1.5e308;
+  matrix(1, 0) = 1.5e308;
+  EXPECT_THROW(matrix.Exp(), std::length_error);
+}
+
+TEST(MultiplyChain, MultiplyChain_test_1) {
+  S21Matrix a(20, 2);
+  S21Matrix b(2, 30);
+  S21Matrix c(30, 3);
+  S21Matrix d(3, 5);
+  for (int i = 0; i < 20; i++) {
+    for (int j = 0; j < 2; j++) {
+      a(i, j) = i - j;
+      b(j, i) = i + j;
+    }
+  }
+  for (int i = 0; i < 30; i++) {
+    for (int j = 0; j < 3; j++) {
+      c(i, j) = (i * j) % 4;
+    }
+  }
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 5; j++) {
+      d(i, j) = i == j;
+    }
+  }
+  S21Matrix expected = a * b * c * d;
+  S21Matrix result = S21Matrix::MultiplyChain({a, b, c, d});
+  EXPECT_EQ(result.GetRows(), 20);
+  EXPECT_EQ(result.GetCols(), 5);
+  EXPECT_TRUE(result == expected);
+  EXPECT_TRUE(S21Matrix::MultiplyChain({a}) == a);
+}
+
+TEST(MultiplyChain, MultiplyChain_test_errors) {
+  S21Matrix a(2, 3);
+  S21Matrix b(2, 3);
+  EXPECT_ANY_THROW(S21Matrix::MultiplyChain({a, b}));
+  EXPECT_ANY_THROW(S21Matrix::MultiplyChain({}));
+}
+
 TEST(Transpose, Transpose_test_1) {
   S21Matrix matrix1(3, 2);
   matrix1(0, 0) = 1;
@@ -493,6 +830,311 @@ TEST(InverseMatrix, InverseMatrix_test_3) {
   EXPECT_EQ(matrix2(0, 0), 0.5);
 }
 
+/// @brief Трёхдиагональная матрица tridiag(-1, 2, -1) с переставленными в
+/// обратном порядке строками. Её определитель равен (n + 1) * (-1)^(n / 2)
+S21Matrix MakeLuTestMatrix(int n) {
+  S21Matrix matrix(n, n);
+  for (int i = 0; i < n; i++) {
+    int row = n - 1 - i;
+    matrix(row, i) = 2;
+    if (i > 0) matrix(row, i - 1) = -1;
+    if (i < n - 1) matrix(row, i + 1) = -1;
+  }
+  return matrix;
+}
+
+TEST(Lu, Determinant_parallel) {
+  EXPECT_NEAR(MakeLuTestMatrix(300).Determinant(), 301, 1e-6);
+  EXPECT_NEAR(MakeLuTestMatrix(7).Determinant(), -8, 1e-9);
+}
+
+TEST(Lu, Inverse_and_solve) {
+  int n = 300;
+  S21Matrix matrix = MakeLuTestMatrix(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      matrix(i, j) += ((i * 7 + j * 13) % 11) / 110.0;
+    }
+  }
+  S21Matrix identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = 1;
+  S21Matrix inverse = matrix.InverseMatrix();
+  EXPECT_LT(MaxAbsDiff(matrix * inverse, identity), 1e-9);
+
+  S21Matrix b(n, 2);
+  for (int i = 0; i < n; i++) {
+    b(i, 0) = i;
+    b(i, 1) = 1;
+  }
+  S21Matrix x = matrix.Solve(b);
+  EXPECT_LT(MaxAbsDiff(matrix * x, b), 1e-7);
+}
+
+TEST(Lu, SolveMixed) {
+  int n = 300;
+  S21Matrix matrix = MakeLuTestMatrix(n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      matrix(i, j) += ((i * 7 + j * 13) % 11) / 110.0 + 1.0 / 3;
+    }
+  }
+  S21Matrix b(n, 1);
+  for (int i = 0; i < n; i++) b(i, 0) = 1.0 / (i + 1);
+  S21Matrix mixed = matrix.SolveMixed(b);
+  S21Matrix exact = matrix.Solve(b);
+  EXPECT_LT(MaxAbsDiff(mixed, exact), 1e-10);
+  EXPECT_LT(MaxAbsDiff(matrix * mixed, b), 1e-12);
+
+  S21Matrix small(5, 5);
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 5; j++) {
+      small(i, j) = 1.0 / (i + j + 1);
+    }
+  }
+  S21Matrix identity = small.Pow(0);
+  EXPECT_LT(MaxAbsDiff(small * small.InverseMatrixMixed(), identity), 1e-9);
+  EXPECT_ANY_THROW(S21Matrix(3, 3).SolveMixed(S21Matrix(3, 1)));
+}
+
+TEST(Lu, Singular) {
+  S21Matrix matrix(5, 5);
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 5; j++) {
+      matrix(i, j) = i + j;
+    }
+  }
+  S21LuFactor lu(matrix);
+  EXPECT_TRUE(lu.IsSingular());
+  EXPECT_ANY_THROW(matrix.InverseMatrix());
+  EXPECT_ANY_THROW(S21LuFactor(S21Matrix(2, 3)));
+}
+
+TEST(Lu, BadlyScaledRows) {
+  S21Matrix matrix(4, 4);
+  matrix(0, 0) = 1e-20;
+  matrix(1, 0) = 1e-21;
+  for (int i = 1; i < 4; i++) matrix(i, i) = 1;
+  EXPECT_FALSE(S21LuFactor(matrix).IsSingular());
+  S21Matrix inverse = matrix.InverseMatrix();
+  EXPECT_DOUBLE_EQ(inverse(0, 0), 1e20);
+  EXPECT_DOUBLE_EQ(inverse(1, 0), -0.1);
+  matrix(3, 3) = 0;
+  EXPECT_TRUE(S21LuFactor(matrix).IsSingular());
+}
+
+TEST(Structured, Triangular) {
+  S21Matrix matrix(3, 3);
+  int count = 1;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      matrix(i, j) = count++;
+    }
+  }
+  const S21TriangularMatrix lower(matrix, S21Triangle::kLower);
+  const S21TriangularMatrix upper(matrix, S21Triangle::kUpper);
+  EXPECT_DOUBLE_EQ(lower(0, 2), 0);
+  EXPECT_DOUBLE_EQ(lower(2, 0), 7);
+  EXPECT_DOUBLE_EQ(upper(0, 2), 3);
+  EXPECT_DOUBLE_EQ(upper(2, 0), 0);
+  S21TriangularMatrix changed(lower);
+  EXPECT_ANY_THROW(changed(0, 1) = 1);
+  EXPECT_DOUBLE_EQ(lower.Determinant(), 45);
+  EXPECT_DOUBLE_EQ(upper.Determinant(), 45);
+  EXPECT_DOUBLE_EQ(lower.ToMatrix().Determinant(), 45);
+
+  EXPECT_TRUE(lower.Mul(matrix) == lower.ToMatrix() * matrix);
+  EXPECT_TRUE(upper.Mul(matrix) == upper.ToMatrix() * matrix);
+  EXPECT_LT(MaxAbsDiff(lower.ToMatrix() * lower.Solve(matrix), matrix), 1e-12);
+  EXPECT_LT(MaxAbsDiff(upper.ToMatrix() * upper.Solve(matrix), matrix), 1e-12);
+  EXPECT_ANY_THROW(S21TriangularMatrix(3, S21Triangle::kLower).Solve(matrix));
+}
+
+TEST(Structured, Symmetric) {
+  S21SymmetricMatrix matrix(3);
+  matrix(0, 0) = 4;
+  matrix(1, 0) = 1;
+  matrix(1, 1) = 3;
+  matrix(2, 1) = 1;
+  matrix(2, 2) = 2;
+  EXPECT_DOUBLE_EQ(matrix(0, 1), 1);
+  S21Matrix full = matrix.ToMatrix();
+  EXPECT_DOUBLE_EQ(full(1, 2), 1);
+  EXPECT_NEAR(matrix.Determinant(), 18, 1e-12);
+  EXPECT_TRUE(matrix.Mul(full) == full * full);
+  EXPECT_LT(MaxAbsDiff(full * matrix.Solve(full), full), 1e-12);
+
+  matrix(0, 0) = -4;
+  S21Matrix indefinite = matrix.ToMatrix();
+  EXPECT_NEAR(S21SymmetricMatrix(indefinite).Determinant(),
+              indefinite.Determinant(), 1e-12);
+  EXPECT_LT(MaxAbsDiff(indefinite * matrix.Solve(full), full), 1e-12);
+}
+
+TEST(Structured, OversizedThrows) {
+  int huge = std::numeric_limits<int>::max();
+  EXPECT_THROW(S21SymmetricMatrix{huge}, std::length_error);
+  EXPECT_THROW(S21TriangularMatrix(huge, S21Triangle::kUpper),
+               std::length_error);
+  EXPECT_THROW(S21BandMatrix(huge, huge, huge), std::length_error);
+  // kl + ku + 1 и 2 * kl + ku + 1 не помещаются в int
+  EXPECT_THROW(S21BandMatrix(1, 1 << 30, 1 << 30), std::length_error);
+  EXPECT_THROW(S21BandMatrix(2, huge / 2, 0), std::length_error);
+  EXPECT_THROW(S21BandMatrix(huge - 2, 1, 1), std::length_error);
+  S21TriangularMatrix upper(4, S21Triangle::kUpper);
+  upper(3, 3) = 7;
+  upper(0, 3) = 2;
+  EXPECT_EQ(upper.ToMatrix()(3, 3), 7);
+  EXPECT_EQ(upper.ToMatrix()(0, 3), 2);
+}
+
+TEST(Structured, Band) {
+  int n = 50;
+  S21BandMatrix band(n, 1, 2);
+  for (int i = 0; i < n; i++) {
+    band(i, i) = 1 + i % 3;
+    if (i > 0) band(i, i - 1) = 2;
+    if (i + 1 < n) band(i, i + 1) = -1;
+    if (i + 2 < n) band(i, i + 2) = 0.5;
+  }
+  const S21BandMatrix& const_band = band;
+  EXPECT_DOUBLE_EQ(const_band(0, 10), 0);
+  EXPECT_ANY_THROW(band(0, 10) = 1);
+  S21Matrix full = band.ToMatrix();
+  EXPECT_NEAR(band.Determinant() / full.Determinant(), 1, 1e-9);
+  S21Matrix b(n, 2);
+  for (int i = 0; i < n; i++) {
+    b(i, 0) = i;
+    b(i, 1) = 1;
+  }
+  EXPECT_LT(MaxAbsDiff(band.Mul(b), full * b), 1e-12);
+  EXPECT_LT(MaxAbsDiff(full * band.Solve(b), b), 1e-9);
+  EXPECT_TRUE(S21BandMatrix(full, 1, 2).ToMatrix() == full);
+}
+
+TEST(ThreadPool, ParallelFor) {
+  std::vector<int> values(1000, 0);
+  S21ThreadPool::Instance().ParallelFor(0, 1000, [&](int from, int to) {
+    for (int i = from; i < to; i++) values[i] = i;
+  });
+  for (int i = 0; i < 1000; i++) EXPECT_EQ(values[i], i);
+}
+
+TEST(ThreadPool, ParallelChunks) {
+  // куски не зависят от размера пула
+  std::int64_t count = 10000, chunk = S21ThreadPool::ChunkLength(3);
+  EXPECT_EQ(chunk, S21ThreadPool::kChunkWork / 3);
+  EXPECT_EQ(S21ThreadPool::ChunkLength(1LL << 20), 1);
+  std::vector<std::int64_t> ends[2];
+  S21ThreadPool small(1), large(7);
+  S21ThreadPool *pools[2] = {&small, &large};
+  for (int p = 0; p < 2; p++) {
+    ends[p].assign((count + chunk - 1) / chunk, 0);
+    pools[p]->ParallelChunks(count, chunk,
+                             [&](std::int64_t from, std::int64_t to) {
+                               ends[p][from / chunk] = to;
+                             });
+  }
+  EXPECT_EQ(ends[0], ends[1]);
+  EXPECT_EQ(ends[0].back(), count);
+  EXPECT_EQ(ends[0][0], chunk);
+}
+
+TEST(ThreadPool, TaskGroup) {
+  std::atomic<int> counter(0);
+  S21TaskGroup group;
+  for (int i = 0; i < 10; i++) {
+    group.Run([&] {
+      counter++;
+      group.Run([&] { counter++; });
+    });
+  }
+  group.Wait();
+  EXPECT_EQ(counter, 20);
+  group.Run([] { throw std::length_error("ошибка"); });
+  EXPECT_THROW(group.Wait(), std::length_error);
+}
+
+TEST(ThreadPool, WaitRunsOnlyOwnTasks) {
+  // посторонние задачи пула ждут флага, который ставится после Wait()
+  std::atomic<bool> release(false);
+  S21ThreadPool pool(1);
+  for (int i = 0; i < 3; i++) {
+    pool.Submit([&release] {
+      while (!release) std::this_thread::yield();
+    });
+  }
+  bool done = false;
+  S21TaskGroup group(pool);
+  group.Run([&done] { done = true; });
+  group.Wait();
+  EXPECT_TRUE(done);
+  release = true;
+}
+
+TEST(Async, Operations) {
+  S21Matrix a(2, 2);
+  S21Matrix b(2, 2);
+  a(0, 0) = 1;
+  a(0, 1) = 2;
+  a(1, 0) = 3;
+  a(1, 1) = 4;
+  b(0, 0) = 1;
+  b(1, 1) = 1;
+  std::future<S21Matrix> product = a.MulMatrixAsync(b);
+  std::future<S21Matrix> sum = a.SumMatrixAsync(b);
+  std::future<S21Matrix> difference = a.SubMatrixAsync(b);
+  std::future<S21Matrix> transpose = a.TransposeAsync();
+  std::future<double> det = a.DeterminantAsync();
+  std::future<S21Matrix> inverse = a.InverseMatrixAsync();
+  std::future<S21Matrix> solution = a.SolveAsync(b);
+  EXPECT_TRUE(product.get() == a);
+  EXPECT_TRUE(sum.get() == a + b);
+  EXPECT_TRUE(difference.get() == a - b);
+  EXPECT_DOUBLE_EQ(transpose.get()(0, 1), 3);
+  EXPECT_DOUBLE_EQ(det.get(), -2);
+  EXPECT_LT(MaxAbsDiff(inverse.get(), solution.get()), 1e-12);
+}
+
+TEST(Async, Errors_and_cancel) {
+  S21Matrix a(2, 3);
+  std::future<S21Matrix> product = a.MulMatrixAsync(a);
+  EXPECT_THROW(product.get(), std::length_error);
+
+  S21CancellationToken token;
+  token.Cancel();
+  std::future<S21Matrix> cancelled = a.TransposeAsync(token);
+  EXPECT_THROW(cancelled.get(), S21OperationCancelled);
+}
+
+TEST(Async, Backpressure) {
+  S21AsyncExecutor executor(2);
+  std::promise<void> gate;
+  std::shared_future<void> opened = gate.get_future().share();
+  std::future<int> first = executor.Submit([opened] {
+    opened.wait();
+    return 1;
+  });
+  std::future<int> second = executor.Submit([opened] {
+    opened.wait();
+    return 2;
+  });
+  EXPECT_EQ(executor.GetPending(), 2);
+  gate.set_value();
+  std::future<int> third = executor.Submit([] { return 3; });
+  EXPECT_EQ(first.get() + second.get() + third.get(), 6);
+}
+
+TEST(Async, NestedSubmit) {
+  // единственное место занято внешней операцией, вложенная выполняется сразу
+  S21ThreadPool pool(1);
+  S21AsyncExecutor executor(1, pool);
+  std::future<int> outer = executor.Submit([&executor] {
+    return executor.Submit([] { return 2; }).get() + 1;
+  });
+  EXPECT_EQ(outer.get(), 3);
+  EXPECT_FALSE(pool.IsWorkerThread());
+}
+
 TEST(operator_overloading, assignment_test_1) {
   S21Matrix matrix1(3, 3);
   int count = 1;
@@ -773,6 +1415,949 @@ TEST(operator_overloading, eq) {
   }
 }
 
+TEST(Reductions, Basic) {
+  S21Matrix matrix(3, 5);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 5; j++) {
+      matrix(i, j) = (i * 5 + j) % 7 - 3;
+    }
+  }
+  matrix(2, 1) = -9;
+  matrix(1, 4) = 8;
+  const S21Matrix &view = matrix;
+  S21Reduction all = view.Reduce();
+  double sum = 0, squares = 0;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 5; j++) {
+      sum += view(i, j);
+      squares += view(i, j) * view(i, j);
+    }
+  }
+  EXPECT_DOUBLE_EQ(all.sum, sum);
+  EXPECT_DOUBLE_EQ(view.Sum(), sum);
+  EXPECT_DOUBLE_EQ(all.sum_squares, squares);
+  EXPECT_DOUBLE_EQ(view.NormFrobenius(), std::sqrt(squares));
+  EXPECT_DOUBLE_EQ(all.max_abs, 9);
+  EXPECT_DOUBLE_EQ(view.Min(), -9);
+  EXPECT_DOUBLE_EQ(view.Max(), 8);
+  EXPECT_EQ(view.ArgMin(), std::make_pair(2, 1));
+  EXPECT_EQ(view.ArgMax(), std::make_pair(1, 4));
+
+  S21Matrix rows = view.RowSums(), cols = view.ColSums();
+  EXPECT_EQ(rows.GetCols(), 1);
+  EXPECT_EQ(cols.GetRows(), 1);
+  double norm1 = 0, norm_inf = 0;
+  for (int i = 0; i < 3; i++) {
+    double row_sum = 0, abs_sum = 0;
+    for (int j = 0; j < 5; j++) {
+      row_sum += view(i, j);
+      abs_sum += std::fabs(view(i, j));
+    }
+    EXPECT_DOUBLE_EQ(rows(i, 0), row_sum);
+    norm_inf = std::max(norm_inf, abs_sum);
+  }
+  for (int j = 0; j < 5; j++) {
+    double col_sum = 0, abs_sum = 0;
+    for (int i = 0; i < 3; i++) {
+      col_sum += view(i, j);
+      abs_sum += std::fabs(view(i, j));
+    }
+    EXPECT_DOUBLE_EQ(cols(0, j), col_sum);
+    norm1 = std::max(norm1, abs_sum);
+  }
+  EXPECT_DOUBLE_EQ(view.Norm1(), norm1);
+  EXPECT_DOUBLE_EQ(view.NormInf(), norm_inf);
+  EXPECT_DOUBLE_EQ(MakeLuTestMatrix(5).Trace(), 2);
+  EXPECT_THROW(view.Trace(), std::length_error);
+  EXPECT_THROW(S21Matrix().Sum(), std::length_error);
+}
+
+TEST(Reductions, Parallel) {
+  int n = 700;
+  S21Matrix matrix(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      matrix(i, j) = (i + 2 * j) % 5;
+    }
+  }
+  matrix(650, 3) = -1;
+  matrix(10, 699) = 7;
+  const S21Matrix &view = matrix;
+  S21Reduction all = view.Reduce();
+  EXPECT_EQ(all.argmin_row, 650);
+  EXPECT_EQ(all.argmax_col, 699);
+  S21Matrix rows = view.RowSums(), cols = view.ColSums();
+  double total = 0, total_rows = 0;
+  for (int i = 0; i < n; i++) total_rows += rows(i, 0);
+  for (int j = 0; j < n; j++) total += cols(0, j);
+  EXPECT_DOUBLE_EQ(all.sum, total);
+  EXPECT_DOUBLE_EQ(all.sum, total_rows);
+  S21Matrix abs_matrix = matrix;
+  abs_matrix(650, 3) = 1;
+  EXPECT_DOUBLE_EQ(view.NormInf(), abs_matrix.RowSums().Max());
+  EXPECT_DOUBLE_EQ(view.Norm1(), abs_matrix.ColSums().Max());
+}
+
+TEST(Reductions, IndependentOfThreshold) {
+  int n = 600;
+  S21Matrix matrix(n, n);
+  S21Vector x(n * n), y(n * n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      matrix(i, j) = 1.0 / (i * n + j + 1);
+      x(i * n + j) = matrix(i, j), y(i * n + j) = 1.0 / (j + 1);
+    }
+  }
+  const S21Matrix &view = matrix;
+  long long threshold = S21Matrix::GetParallelThreshold();
+  double expected[3] = {};
+  for (int pass = 0; pass < 2; pass++) {
+    S21Matrix::SetParallelThreshold(pass == 0 ? 1LL << 40 : 1);
+    double results[3] = {view.Sum(), view.NormFrobenius(), x.Dot(y)};
+    for (int r = 0; r < 3; r++) {
+      if (pass == 0)
+        expected[r] = results[r];
+      else
+        EXPECT_EQ(results[r], expected[r]);
+    }
+  }
+  S21Matrix::SetParallelThreshold(threshold);
+}
+
+TEST(ElementWise, ApplyMap) {
+  S21Matrix matrix(2, 3);
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 3; j++) {
+      matrix(i, j) = i * 3 + j - 2;
+    }
+  }
+  S21Matrix copy = matrix;
+  S21Matrix squared = matrix.Map([](double x) { return x * x; });
+  EXPECT_EQ(squared(0, 0), 4);
+  EXPECT_EQ(squared(1, 2), 9);
+  matrix.Apply([](double x) { return std::clamp(x, -1.0, 1.0); });
+  EXPECT_EQ(matrix(0, 0), -1);
+  EXPECT_EQ(matrix(1, 2), 1);
+  EXPECT_EQ(copy(0, 0), -2);
+  S21Matrix destination(2, 3);
+  copy.Map([](double x) { return -x; }, &destination);
+  EXPECT_EQ(destination(1, 1), -2);
+  S21Matrix wrong(3, 2);
+  EXPECT_THROW(copy.Map([](double x) { return x; }, &wrong),
+               std::length_error);
+}
+
+TEST(ElementWise, Zip) {
+  S21Matrix a(2, 2), mask(2, 2), c(2, 2);
+  a(0, 0) = 1, a(0, 1) = 2, a(1, 0) = 3, a(1, 1) = 4;
+  mask(0, 1) = mask(1, 0) = 1;
+  c(0, 0) = c(0, 1) = c(1, 0) = c(1, 1) = 10;
+  S21Matrix masked = a;
+  masked.Zip(mask, [](double x, double m) { return m != 0 ? x : 0; });
+  EXPECT_EQ(masked(0, 0), 0);
+  EXPECT_EQ(masked(0, 1), 2);
+  S21Matrix fma(2, 2);
+  a.Zip3(a, c, [](double x, double y, double z) { return x * y + z; }, &fma);
+  EXPECT_EQ(fma(1, 1), 26);
+  a.Zip3(mask, c, [](double x, double m, double z) { return m ? z : x; });
+  EXPECT_EQ(a(0, 0), 1);
+  EXPECT_EQ(a(1, 0), 10);
+  S21Matrix wrong(2, 3);
+  EXPECT_THROW(a.Zip(wrong, [](double x, double) { return x; }),
+               std::length_error);
+}
+
+TEST(ElementWise, Parallel) {
+  int n = 600;
+  S21Matrix a(n, n), b(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      a(i, j) = i - j;
+      b(i, j) = j;
+    }
+  }
+  S21Matrix sum(n, n);
+  a.Zip(b, [](double x, double y) { return x + y; }, &sum);
+  a.Apply([](double x) { return 2 * x; });
+  for (int i = 0; i < n; i += 37) {
+    for (int j = 0; j < n; j += 41) {
+      EXPECT_EQ(sum(i, j), i);
+      EXPECT_EQ(a(i, j), 2 * (i - j));
+    }
+  }
+}
+
+TEST(Exact, Determinant) {
+  S21Matrix matrix(3, 3);
+  int values[3][3] = {{2, 5, 7}, {6, 3, 4}, {5, -2, -3}};
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      matrix(i, j) = values[i][j];
+    }
+  }
+  EXPECT_EQ(matrix.DeterminantInt(), -1);
+  EXPECT_EQ(matrix.DeterminantExact(), "-1");
+  EXPECT_EQ(MakeLuTestMatrix(9).DeterminantInt(), 10);
+
+  S21Matrix scaled(2, 2);
+  scaled(0, 0) = scaled(1, 1) = 1e-5;
+  EXPECT_DOUBLE_EQ(scaled.InverseMatrix()(0, 0), 1e5);
+
+  int n = 20;
+  S21Matrix big(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      big(i, j) = i == j ? 1000000007 : (i * 31 + j * 17) % 1000;
+    }
+  }
+  std::string det = big.DeterminantExact();
+  EXPECT_GT(det.size(), 170u);
+  EXPECT_THROW(big.DeterminantInt(), std::overflow_error);
+  S21Matrix swapped = big;
+  for (int j = 0; j < n; j++) std::swap(swapped(0, j), swapped(1, j));
+  EXPECT_EQ(swapped.DeterminantExact(), "-" + det);
+  EXPECT_THROW(scaled.DeterminantInt(), std::length_error);
+}
+
+TEST(Exact, Int64Boundary) {
+  // Определитель и миноры ровно -2^63 и 2^63
+  S21Matrix matrix(3, 3);
+  matrix(0, 0) = 9007199254740992.0;  // 2^53
+  matrix(1, 1) = 1024;
+  matrix(2, 2) = -1;
+  EXPECT_EQ(matrix.DeterminantInt(), std::numeric_limits<std::int64_t>::min());
+  EXPECT_EQ(matrix.DeterminantExact(), "-9223372036854775808");
+  EXPECT_EQ(matrix.RankExact(), 3);
+  matrix(2, 2) = 1;
+  EXPECT_THROW(matrix.DeterminantInt(), std::overflow_error);
+  EXPECT_EQ(matrix.DeterminantExact(), "9223372036854775808");
+  matrix(1, 1) = -1024;
+  EXPECT_EQ(matrix.DeterminantInt(), std::numeric_limits<std::int64_t>::min());
+  for (int j = 0; j < 3; j++) std::swap(matrix(0, j), matrix(1, j));
+  EXPECT_EQ(matrix.DeterminantExact(), "9223372036854775808");
+  matrix(2, 2) = 0;
+  EXPECT_EQ(matrix.RankExact(), 2);
+}
+
+TEST(Exact, Rank) {
+  S21Matrix matrix(4, 5);
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 5; j++) {
+      matrix(i, j) = (i + 1) * (j + 2);
+    }
+  }
+  EXPECT_EQ(matrix.RankExact(), 1);
+  matrix(3, 4) += 1;
+  EXPECT_EQ(matrix.RankExact(), 2);
+  EXPECT_EQ(S21Matrix(3, 3).RankExact(), 0);
+  EXPECT_EQ(MakeLuTestMatrix(30).RankExact(), 30);
+
+  int n = 12;
+  S21Matrix big(n + 1, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      big(i, j) = i == j ? 4000000000000 : (i * 7 + j * 3) % 11;
+    }
+  }
+  for (int j = 0; j < n; j++) big(n, j) = big(0, j) + big(1, j);
+  EXPECT_EQ(big.RankExact(), n);
+}
+
+TEST(Qr, Factorization) {
+  int m = 150, n = 40;
+  S21Matrix matrix(m, n);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      matrix(i, j) = std::sin(i * 0.37 + j * 1.3) + (i == j ? 2 : 0);
+    }
+  }
+  S21QrFactor qr(matrix);
+  EXPECT_TRUE(qr.IsFullRank());
+  S21Matrix q = qr.GetQ(), r = qr.GetR();
+  EXPECT_LT(MaxAbsDiff(q * r, matrix), 1e-12);
+  S21Matrix gram(n, n), identity(n, n);
+  gram.Gemm(1.0, q, q, 0.0, true);
+  for (int i = 0; i < n; i++) identity(i, i) = 1;
+  EXPECT_LT(MaxAbsDiff(gram, identity), 1e-13);
+  for (int i = 1; i < n; i++) EXPECT_EQ(r(i, i - 1), 0);
+  EXPECT_LT(MaxAbsDiff(qr.ApplyQ(qr.ApplyQt(matrix)), matrix), 1e-12);
+}
+
+TEST(Qr, LeastSquares) {
+  int m = 200, n = 35;
+  S21Matrix matrix(m, n), expected(n, 2);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      matrix(i, j) = std::cos(i * 0.11 * (j + 1));
+    }
+  }
+  for (int j = 0; j < n; j++) {
+    expected(j, 0) = j + 1;
+    expected(j, 1) = 1.0 / (j + 1);
+  }
+  S21Matrix b = matrix * expected;
+  EXPECT_LT(MaxAbsDiff(matrix.LeastSquares(b), expected), 1e-9);
+
+  for (int i = 0; i < m; i++) b(i, 0) += (i % 3) - 1.0;
+  S21Matrix x = S21QrFactor(matrix).LeastSquares(b);
+  S21Matrix residual = b;
+  residual.Gemm(1.0, matrix, x, -1.0);
+  S21Matrix normal(n, 2);
+  normal.Gemm(1.0, matrix, residual, 0.0, true);
+  EXPECT_LT(MaxAbsDiff(normal, S21Matrix(n, 2)), 1e-10);
+
+  S21Matrix deficient(4, 2);
+  for (int i = 0; i < 4; i++) deficient(i, 0) = deficient(i, 1) = i + 1;
+  EXPECT_THROW(deficient.LeastSquares(S21Matrix(4, 1)), std::length_error);
+  EXPECT_THROW(S21QrFactor(S21Matrix(2, 3)), std::length_error);
+}
+
+TEST(Cache, DerivedResults) {
+  S21Matrix::SetCaching(true);
+  S21Matrix::ResetCacheStats();
+  S21Matrix matrix = MakeLuTestMatrix(6);
+  double det = matrix.Determinant();
+  S21Matrix inverse = matrix.InverseMatrix();
+  S21CacheStats stats = S21Matrix::GetCacheStats();
+  EXPECT_EQ(stats.misses, 3u);
+  EXPECT_EQ(stats.hits, 1u);
+
+  EXPECT_DOUBLE_EQ(matrix.Determinant(), det);
+  EXPECT_EQ(MaxAbsDiff(matrix.InverseMatrix(), inverse), 0);
+  S21Matrix b(6, 1);
+  b(0, 0) = 1;
+  matrix.Solve(b);
+  EXPECT_EQ(S21Matrix::GetCacheStats().hits, 4u);
+
+  matrix(0, 0) += 1;
+  EXPECT_EQ(S21Matrix::GetCacheStats().invalidations, 1u);
+  EXPECT_NEAR(matrix.Determinant(), S21LuFactor(matrix).Determinant(), 1e-9);
+  S21Matrix transposed = matrix.Transpose();
+  S21Matrix copy = matrix;
+  copy.SetRows(5);
+  EXPECT_EQ(MaxAbsDiff(matrix.Transpose(), transposed), 0);
+  EXPECT_EQ(S21Matrix::GetCacheStats().hits, 5u);
+  // попадание в кеш разделяет буфер, изменение копии кеш не портит
+  S21Matrix hit = matrix.Transpose();
+  EXPECT_TRUE(hit.IsShared());
+  hit(0, 1) = 100;
+  EXPECT_FALSE(hit.IsShared());
+  EXPECT_EQ(MaxAbsDiff(matrix.Transpose(), transposed), 0);
+  matrix.MulNumber(2);
+  EXPECT_DOUBLE_EQ(matrix.Transpose()(0, 0), 2 * transposed(0, 0));
+
+  S21Matrix::SetCaching(false);
+  EXPECT_FALSE(S21Matrix::GetCaching());
+  S21Matrix::ResetCacheStats();
+  matrix.Determinant();
+  EXPECT_EQ(S21Matrix::GetCacheStats().misses, 0u);
+}
+
+TEST(MaintainedInverse, RankOne) {
+  int n = 6;
+  S21Matrix matrix = MakeLuTestMatrix(n);
+  S21MaintainedInverse tracker(matrix);
+  S21Matrix u(n, 1), v(n, 1);
+  for (int i = 0; i < n; i++) {
+    u(i, 0) = 0.1 * (i + 1);
+    v(i, 0) = 0.05 * (n - i);
+  }
+  tracker.RankOneUpdate(u, v);
+  tracker.UpdateEntry(2, 3, 0.5);
+  tracker.SetEntry(0, 0, 4);
+  EXPECT_EQ(tracker.GetUpdates(), 3);
+
+  S21Matrix current = tracker.GetMatrix();
+  EXPECT_DOUBLE_EQ(current(0, 0), 4);
+  S21LuFactor lu(current);
+  EXPECT_LT(MaxAbsDiff(tracker.GetInverse(), lu.Inverse()), 1e-9);
+  EXPECT_NEAR(tracker.Determinant(), lu.Determinant(), 1e-9);
+  EXPECT_ANY_THROW(tracker.UpdateEntry(n, 0, 1));
+}
+
+TEST(MaintainedInverse, RankK) {
+  int n = 8, k = 3;
+  S21MaintainedInverse tracker(MakeLuTestMatrix(n), 4);
+  S21Matrix u(n, k), v(n, k);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < k; j++) {
+      u(i, j) = ((i + 2 * j) % 5) * 0.1;
+      v(i, j) = ((3 * i + j) % 4) * 0.1;
+    }
+  }
+  tracker.RankUpdate(u, v);
+  EXPECT_EQ(tracker.GetUpdates(), 3);
+  tracker.RankUpdate(u, v);
+  EXPECT_EQ(tracker.GetUpdates(), 0);
+
+  S21Matrix current = tracker.GetMatrix();
+  S21LuFactor lu(current);
+  EXPECT_LT(MaxAbsDiff(tracker.GetInverse(), lu.Inverse()), 1e-9);
+  EXPECT_NEAR(tracker.Determinant(), lu.Determinant(), 1e-9);
+
+  S21Matrix identity(2, 2);
+  identity(0, 0) = identity(1, 1) = 1;
+  S21MaintainedInverse small(identity);
+  EXPECT_THROW(small.UpdateEntry(0, 0, -1), std::length_error);
+  EXPECT_DOUBLE_EQ(small.Determinant(), 1);
+  EXPECT_THROW(S21MaintainedInverse(S21Matrix(2, 2)), std::length_error);
+}
+
+TEST(MaintainedInverse, RelativeStability) {
+  int n = 6;
+  S21Matrix matrix = MakeLuTestMatrix(n);
+  matrix.MulNumber(1e-5);
+  S21MaintainedInverse scaled(matrix);
+  S21Matrix u(n, 1), v(n, 1);
+  for (int i = 0; i < n; i++) {
+    u(i, 0) = 1e-6 * (i + 1);
+    v(i, 0) = 0.05 * (n - i);
+  }
+  scaled.RankOneUpdate(u, v);
+  EXPECT_EQ(scaled.GetUpdates(), 1);
+  S21LuFactor lu(scaled.GetMatrix());
+  EXPECT_LT(MaxAbsDiff(scaled.GetInverse(), lu.Inverse()), 1e-9 * 1e5);
+
+  // 1 + v^T u = 1.5 после сокращения слагаемых порядка 1e12: матрица
+  // численно вырождена, и формула не должна её принимать
+  S21Matrix identity(2, 2);
+  identity(0, 0) = identity(1, 1) = 1;
+  S21MaintainedInverse tracker(identity);
+  S21Matrix x(2, 1), y(2, 1);
+  x(0, 0) = x(1, 0) = 1e6;
+  y(0, 0) = 1e6;
+  y(1, 0) = -1e6 + 5e-7;
+  EXPECT_THROW(tracker.RankOneUpdate(x, y), std::length_error);
+}
+
+TEST(Memory, Stats) {
+  S21MemoryStats before = S21Allocator::GetStats();
+  {
+    S21Matrix matrix(10, 10);
+    S21MemoryStats during = S21Allocator::GetStats();
+    EXPECT_EQ(during.live_bytes, before.live_bytes + 800);
+    EXPECT_GE(during.peak_bytes, during.live_bytes);
+    EXPECT_EQ(during.allocations, before.allocations + 1);
+    matrix.Transpose();
+  }
+  S21MemoryStats after = S21Allocator::GetStats();
+  EXPECT_EQ(after.live_bytes, before.live_bytes);
+  EXPECT_EQ(after.deallocations, before.deallocations + 2);
+  S21Allocator::ResetPeak();
+  EXPECT_EQ(S21Allocator::GetStats().peak_bytes, after.live_bytes);
+
+  auto operations = S21Allocator::GetOperationStats();
+  EXPECT_GE(operations["Transpose"].allocations, 1u);
+  EXPECT_GE(operations["Transpose"].bytes, 800u);
+}
+
+TEST(Memory, HooksAndLimit) {
+  std::size_t allocated = 0, freed = 0;
+  int hook = S21Allocator::AddHook([&](const S21AllocEvent &event) {
+    (event.allocated ? allocated : freed) += event.bytes;
+    EXPECT_STREQ(event.operation, "test");
+  });
+  {
+    S21MemoryScope scope("test");
+    S21Matrix matrix(4, 8);
+  }
+  S21Allocator::RemoveHook(hook);
+  S21Matrix unobserved(2, 2);
+  EXPECT_EQ(allocated, 256u);
+  EXPECT_EQ(freed, 256u);
+  EXPECT_STREQ(S21MemoryScope::Current(), "other");
+
+  S21Allocator::SetMemoryLimit(S21Allocator::GetStats().live_bytes + 1000);
+  S21Matrix fits(10, 10);
+  EXPECT_THROW(S21Matrix(10, 10), S21MemoryLimitExceeded);
+  EXPECT_THROW(fits.SetRows(20), std::bad_alloc);
+  EXPECT_EQ(fits.GetRows(), 10);
+  S21Allocator::SetMemoryLimit(0);
+  EXPECT_EQ(S21Allocator::GetMemoryLimit(), 0u);
+  EXPECT_NO_THROW(S21Matrix(10, 10));
+}
+
+TEST(TextIo, RoundTrip) {
+  S21Matrix matrix(3, 4);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 4; j++) {
+      matrix(i, j) = (i - 1.5) / (j + 3) * 1e-3 + j * 1e20;
+    }
+  }
+  std::stringstream stream;
+  matrix.WriteText(stream, ',');
+  S21Matrix loaded = S21Matrix::ReadText(stream);
+  EXPECT_EQ(loaded.GetRows(), 3);
+  EXPECT_EQ(loaded.GetCols(), 4);
+  EXPECT_EQ(MaxAbsDiff(loaded, matrix), 0);
+
+  std::ostringstream text;
+  S21Matrix(1, 2).WriteText(text);
+  EXPECT_EQ(text.str(), "0 0\n");
+}
+
+TEST(TextIo, EmptyRowsFlushBuffer) {
+  int rows = (1 << 20) + 5;
+  std::ostringstream text;
+  S21Matrix(rows, 0).WriteText(text);
+  EXPECT_EQ(text.str(), std::string(rows, '\n'));
+}
+
+TEST(TextIo, Parse) {
+  S21Matrix matrix =
+      S21Matrix::ParseText("1, 2.5;-3\r\n\n\t+4 5e2 0.125\n");
+  EXPECT_EQ(matrix.GetRows(), 2);
+  EXPECT_EQ(matrix.GetCols(), 3);
+  EXPECT_DOUBLE_EQ(matrix(0, 1), 2.5);
+  EXPECT_DOUBLE_EQ(matrix(0, 2), -3);
+  EXPECT_DOUBLE_EQ(matrix(1, 0), 4);
+  EXPECT_DOUBLE_EQ(matrix(1, 1), 500);
+  EXPECT_EQ(S21Matrix::ParseText("\n\n").GetRows(), 0);
+  EXPECT_THROW(S21Matrix::ParseText("1 2\n3\n"), std::length_error);
+  EXPECT_THROW(S21Matrix::ParseText("1 2x\n"), std::invalid_argument);
+  EXPECT_THROW(S21Matrix::ReadTextFile("/nonexistent/matrix.txt"),
+               std::runtime_error);
+}
+
+TEST(TextIo, LargeFile) {
+  S21Matrix matrix(300, 300);
+  for (int i = 0; i < 300; i++) {
+    for (int j = 0; j < 300; j++) {
+      matrix(i, j) = (i * 300 + j) / 7.0;
+    }
+  }
+  char path[] = "/tmp/s21_matrix_XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  matrix.WriteText(fd, '\t');
+  close(fd);
+  S21Matrix loaded = S21Matrix::ReadTextFile(path);
+  unlink(path);
+  EXPECT_EQ(loaded.GetRows(), 300);
+  EXPECT_EQ(MaxAbsDiff(loaded, matrix), 0);
+}
+
+S21Matrix MakeDistributedTestMatrix(int rows, int cols, int seed) {
+  S21Matrix matrix(rows, cols);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      matrix(i, j) = (i * 7 + j * 3 + seed) % 11 - 5;
+    }
+  }
+  return matrix;
+}
+
+// Процессы, кроме нулевого, не видят EXPECT, поэтому проверки внутри групп
+// процессов бросают исключение, которое Run пробрасывает в тест
+void CheckNear(const S21Matrix &a, const S21Matrix &b) {
+  if (MaxAbsDiff(a, b) > 1e-9) throw std::runtime_error("результат неверен");
+}
+
+TEST(Distributed, BroadcastSplit) {
+  EXPECT_NO_THROW(S21ShmCommunicator::Run(4, [](S21Communicator &comm) {
+    std::vector<int> data(1000, comm.Rank());
+    comm.Broadcast(data.data(), data.size() * sizeof(int), 2);
+    if (data[999] != 2) throw std::runtime_error("рассылка неверна");
+    auto half = comm.Split(comm.Rank() % 2, -comm.Rank());
+    if (half->Size() != 2 || half->Rank() != 1 - comm.Rank() / 2)
+      throw std::runtime_error("разбиение неверно");
+    int value = comm.Rank();
+    half->Broadcast(&value, sizeof(value), 0);
+    if (value != 2 + comm.Rank() % 2)
+      throw std::runtime_error("рассылка в подгруппе неверна");
+  }, 64));
+}
+
+TEST(Distributed, MulTransposeSquareGrid) {
+  S21Matrix a = MakeDistributedTestMatrix(7, 300, 1);
+  S21Matrix b = MakeDistributedTestMatrix(300, 5, 2);
+  EXPECT_NO_THROW(S21ShmCommunicator::Run(4, [&](S21Communicator &comm) {
+    S21ProcessGrid grid(comm);
+    if (grid.Rows() != 2 || grid.Cols() != 2)
+      throw std::runtime_error("решётка неверна");
+    S21DistributedMatrix da(grid, a), db(grid, b);
+    CheckNear(da.MulMatrix(db).Gather(), a * b);
+    CheckNear(da.Transpose().Gather(), a.Transpose());
+    CheckNear(da.Gather(), a);
+  }));
+}
+
+TEST(Distributed, RectangularGrid) {
+  S21Matrix a = MakeDistributedTestMatrix(5, 8, 3);
+  S21Matrix b = MakeDistributedTestMatrix(8, 2, 4);
+  EXPECT_NO_THROW(S21ShmCommunicator::Run(3, [&](S21Communicator &comm) {
+    S21ProcessGrid grid(comm);
+    S21DistributedMatrix da(grid, a), db(grid, b);
+    CheckNear(da.MulMatrix(db).Gather(), a * b);
+    CheckNear(da.Transpose().Gather(), a.Transpose());
+    S21DistributedMatrix wrong(grid, 3, 3);
+    bool thrown = false;
+    try {
+      da.MulMatrix(wrong);
+    } catch (const std::length_error &) {
+      thrown = true;
+    }
+    if (!thrown) throw std::runtime_error("нет проверки размерности");
+  }, 40));
+}
+
+TEST(Distributed, FailurePropagates) {
+  EXPECT_THROW(S21ShmCommunicator::Run(3, [](S21Communicator &comm) {
+    if (comm.Rank() == 2) throw std::runtime_error("ошибка процесса");
+    comm.Barrier();
+  }), std::runtime_error);
+  EXPECT_THROW(S21ShmCommunicator::Run(0, [](S21Communicator &) {}),
+               std::length_error);
+}
+
+TEST(Distributed, AllToAll) {
+  // Части разной длины, буфер на несколько раундов
+  EXPECT_NO_THROW(S21ShmCommunicator::Run(3, [](S21Communicator &comm) {
+    std::vector<std::size_t> send_bytes, recv_bytes;
+    std::vector<int> send, recv;
+    for (int r = 0; r < comm.Size(); ++r) {
+      int count = 10 * comm.Rank() + r;
+      send.insert(send.end(), count, 100 * comm.Rank() + r);
+      send_bytes.push_back(count * sizeof(int));
+      recv_bytes.push_back((10 * r + comm.Rank()) * sizeof(int));
+    }
+    std::size_t total = 0;
+    for (std::size_t bytes : recv_bytes) total += bytes / sizeof(int);
+    recv.resize(total);
+    comm.AllToAll(send.data(), send_bytes.data(), recv.data(),
+                  recv_bytes.data());
+    std::size_t position = 0;
+    for (int r = 0; r < comm.Size(); ++r)
+      for (int k = 0; k < 10 * r + comm.Rank(); ++k)
+        if (recv[position++] != 100 * r + comm.Rank())
+          throw std::runtime_error("обмен неверен");
+  }, 64));
+}
+
+TEST(Distributed, RequiresSingleThread) {
+  std::promise<void> release;
+  std::thread other([&release] { release.get_future().wait(); });
+  EXPECT_THROW(S21ShmCommunicator::Run(2, [](S21Communicator &) {}),
+               std::logic_error);
+  release.set_value();
+  other.join();
+  std::promise<void> nested;
+  std::future<void> nested_result = nested.get_future();
+  S21ThreadPool::Instance().Submit([&nested] {
+    try {
+      S21ShmCommunicator::Run(2, [](S21Communicator &) {});
+      nested.set_value();
+    } catch (...) {
+      nested.set_exception(std::current_exception());
+    }
+  });
+  EXPECT_THROW(nested_result.get(), std::logic_error);
+  // Пул, занятый задачами, дожидается их перед fork()
+  std::atomic<int> done(0);
+  for (int i = 0; i < 8; ++i)
+    S21ThreadPool::Instance().Submit([&done] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      ++done;
+    });
+  EXPECT_NO_THROW(S21ShmCommunicator::Run(2, [](S21Communicator &comm) {
+    comm.Barrier();
+  }));
+  EXPECT_EQ(done, 8);
+}
+
+TEST(Distributed, EarlyExitAborts) {
+  // процесс завершается до барьера, не выставив флаг ошибки
+  EXPECT_THROW(S21ShmCommunicator::Run(3, [](S21Communicator &comm) {
+    if (comm.Rank() == 1) _exit(1);
+    if (comm.Rank() == 2) raise(SIGKILL);
+    comm.Barrier();
+  }), std::runtime_error);
+}
+
+TEST(ExternalBuffer, Borrow) {
+  double data[3][4] = {{1, 2, 3, -1}, {4, 5, 6, -1}, {7, 8, 9, -1}};
+  S21Matrix matrix = S21Matrix::Borrow(&data[0][0], 3, 3, 4);
+  EXPECT_TRUE(matrix.IsExternal());
+  EXPECT_EQ(matrix(2, 1), 8);
+  matrix(1, 1) = 50;
+  EXPECT_EQ(data[1][1], 50);
+  matrix.MulNumber(2);
+  EXPECT_EQ(data[2][2], 18);
+  EXPECT_EQ(data[0][3], -1);
+  S21Matrix copy = matrix;
+  copy(0, 0) = 0;
+  EXPECT_EQ(data[0][0], 2);
+  matrix.SetCols(4);
+  EXPECT_FALSE(matrix.IsExternal());
+  EXPECT_EQ(matrix(0, 3), 0);
+  EXPECT_EQ(data[0][3], -1);
+  EXPECT_THROW(S21Matrix::Borrow(&data[0][0], 3, 5, 4), std::length_error);
+  EXPECT_THROW(S21Matrix::Borrow(nullptr, 3, 3), std::invalid_argument);
+}
+
+TEST(ExternalBuffer, Adopt) {
+  int freed = 0;
+  S21Deleter deleter = [&freed](double *data) {
+    ++freed;
+    delete[] data;
+  };
+  {
+    double *data = new double[6]{1, 2, 3, 4, 5, 6};
+    S21Matrix::SetCopyOnWrite(true);
+    S21Matrix matrix = S21Matrix::Adopt(data, 2, 3, deleter);
+    EXPECT_EQ(matrix.GetMatrix(1, 0), 4);
+    S21Matrix shared = matrix;
+    S21Matrix::SetCopyOnWrite(false);
+    EXPECT_TRUE(matrix.IsShared());
+    matrix = S21Matrix();
+    EXPECT_EQ(freed, 0);
+    EXPECT_EQ(shared(1, 2), 6);
+  }
+  EXPECT_EQ(freed, 1);
+
+  // По столбцам: матрица 2 x 3 {{1, 2, 3}, {4, 5, 6}}
+  double *columns = new double[6]{1, 4, 2, 5, 3, 6};
+  S21Matrix matrix =
+      S21Matrix::Adopt(columns, 2, 3, deleter, S21Layout::kColMajor);
+  EXPECT_EQ(matrix.GetMatrix(0, 2), 3);
+  EXPECT_EQ(matrix.GetMatrix(1, 0), 4);
+  S21Buffer buffer = matrix.Release();
+  EXPECT_EQ(matrix.GetRows(), 0);
+  EXPECT_EQ(buffer.data, columns);
+  EXPECT_EQ(buffer.stride, 3);
+  EXPECT_EQ(buffer.data[5], 6);
+  buffer.deleter(buffer.data);
+  EXPECT_EQ(freed, 2);
+}
+
+TEST(ExternalBuffer, AdoptColMajor) {
+  int rows = 7, cols = 13;
+  double *data = new double[rows * cols];
+  for (int j = 0; j < cols; j++) {
+    for (int i = 0; i < rows; i++) {
+      data[j * rows + i] = i * 100 + j;
+    }
+  }
+  S21Matrix matrix = S21Matrix::Adopt(
+      data, rows, cols, [](double *p) { delete[] p; }, S21Layout::kColMajor);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      EXPECT_EQ(matrix.GetMatrix(i, j), i * 100 + j);
+    }
+  }
+  // при ошибке проверки буфер не переставляется и не освобождается
+  double column[6] = {1, 4, 2, 5, 3, 6};
+  EXPECT_THROW(S21Matrix::Adopt(column, 2, 3, {}, S21Layout::kColMajor, 3),
+               std::length_error);
+  EXPECT_THROW(S21Matrix::Adopt(nullptr, 2, 3, {}, S21Layout::kColMajor),
+               std::invalid_argument);
+  EXPECT_EQ(column[1], 4);
+}
+
+TEST(ExternalBuffer, Release) {
+  S21Matrix matrix(2, 2);
+  matrix(1, 0) = 3;
+  S21Buffer buffer = matrix.Release();
+  EXPECT_EQ(buffer.rows, 2);
+  EXPECT_EQ(buffer.data[2], 3);
+  S21Matrix adopted = S21Matrix::Adopt(buffer.data, buffer.rows, buffer.cols,
+                                       std::move(buffer.deleter),
+                                       S21Layout::kRowMajor, buffer.stride);
+  EXPECT_EQ(adopted(1, 0), 3);
+  EXPECT_EQ(S21Matrix().Release().data, nullptr);
+}
+
+TEST(Vector, Basic) {
+  S21Vector x = {1, 2, 3};
+  S21Vector y(3);
+  EXPECT_EQ(y.GetSize(), 3);
+  y(0) = 4, y(1) = -5, y(2) = 6;
+  EXPECT_DOUBLE_EQ(x.Dot(y), 12);
+  EXPECT_DOUBLE_EQ(S21Vector({3, 4}).Norm(), 5);
+  y.Axpy(2, x);
+  EXPECT_EQ(y(1), -1);
+  y.Scal(0.5);
+  EXPECT_EQ(y(2), 6);
+  S21Matrix column = x.ToMatrix();
+  EXPECT_EQ(column.GetRows(), 3);
+  EXPECT_EQ(column.GetCols(), 1);
+  EXPECT_EQ(S21Vector(column)(2), 3);
+  EXPECT_THROW(x.Dot(S21Vector(2)), std::length_error);
+  EXPECT_THROW(x(3), std::length_error);
+  EXPECT_THROW(S21Vector(S21Matrix(2, 2)), std::length_error);
+}
+
+TEST(Vector, GemvGer) {
+  S21Matrix a(2, 3);
+  a(0, 0) = 1, a(0, 1) = 2, a(0, 2) = 3;
+  a(1, 0) = 4, a(1, 1) = 5, a(1, 2) = 6;
+  S21Vector x = {1, 0, -1};
+  S21Vector y = a * x;
+  EXPECT_EQ(y(0), -2);
+  EXPECT_EQ(y(1), -2);
+  S21Vector z = {1, 1, 1};
+  z.Gemv(2, a, S21Vector({1, -1}), 1, true);
+  EXPECT_EQ(z(0), -5);
+  EXPECT_EQ(z(2), -5);
+  EXPECT_THROW(z.Gemv(1, a, z, 0), std::length_error);
+  a.Ger(1, S21Vector({1, 2}), S21Vector({1, 0, 1}));
+  EXPECT_EQ(a(1, 0), 6);
+  EXPECT_EQ(a(1, 1), 5);
+  EXPECT_THROW(a.Ger(1, x, x), std::length_error);
+}
+
+TEST(Vector, Parallel) {
+  int m = 500, n = 400;
+  S21Matrix a(m, n);
+  S21Vector x(n), w(m);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      a(i, j) = (i * 3 + j) % 7 - 3;
+    }
+    w(i) = i % 5;
+  }
+  for (int j = 0; j < n; j++) x(j) = j % 3;
+  S21Matrix expected = a * x.ToMatrix();
+  EXPECT_EQ(MaxAbsDiff((a * x).ToMatrix(), expected), 0);
+  S21Vector t(n);
+  t.Gemv(1, a, w, 0, true);
+  EXPECT_EQ(MaxAbsDiff(t.ToMatrix(), a.Transpose() * w.ToMatrix()), 0);
+  S21Vector big(100000), ones(100000);
+  for (int i = 0; i < 100000; i++) big(i) = i % 10, ones(i) = 1;
+  EXPECT_EQ(big.Dot(ones), 450000);
+  S21Matrix outer(m, n);
+  outer.Ger(2, w, x);
+  EXPECT_EQ(outer(499, 2), 2 * 4 * 2);
+}
+
+TEST(SmallBuffer, NoAllocations) {
+  std::size_t before = S21Allocator::GetStats().allocations;
+  S21Matrix a(4, 4), b(2, 3);
+  a(3, 3) = 2;
+  S21Matrix c = a * a;
+  c += a;
+  S21Matrix moved = std::move(c);
+  std::swap(moved, b);
+  EXPECT_EQ(S21Allocator::GetStats().allocations, before);
+  EXPECT_EQ(b(3, 3), 6);
+  EXPECT_EQ(moved.GetRows(), 2);
+  EXPECT_EQ(c.GetRows(), 0);
+  S21Matrix big(4, 5);
+  EXPECT_EQ(S21Allocator::GetStats().allocations, before + 1);
+}
+
+TEST(SmallBuffer, Growth) {
+  S21Matrix matrix(2, 2);
+  matrix(1, 1) = 5;
+  matrix.SetCols(3);
+  EXPECT_EQ(matrix(1, 1), 5);
+  matrix.SetRows(9);
+  EXPECT_EQ(matrix(1, 1), 5);
+  EXPECT_EQ(matrix(8, 2), 0);
+  matrix.SetRows(3);
+  std::size_t before = S21Allocator::GetStats().allocations;
+  matrix.ShrinkToFit();
+  EXPECT_EQ(S21Allocator::GetStats().allocations, before);
+  EXPECT_EQ(matrix(1, 1), 5);
+  matrix.SetCols(5);
+  EXPECT_EQ(matrix(1, 1), 5);
+  EXPECT_EQ(matrix.GetRows(), 3);
+
+  S21Matrix::SetCopyOnWrite(true);
+  S21Matrix small(2, 2);
+  S21Matrix copy = small;
+  S21Matrix::SetCopyOnWrite(false);
+  EXPECT_FALSE(small.IsShared());
+  copy(0, 0) = 1;
+  EXPECT_EQ(small(0, 0), 0);
+
+  S21Buffer buffer = copy.Release();
+  EXPECT_EQ(buffer.data[0], 1);
+  buffer.deleter(buffer.data);
+}
+
+TEST(ParallelOps, MatchSequential) {
+  int rows = 300, cols = 170;
+  S21Matrix a(rows, cols), b(rows, cols);
+  for (int i = 0; i < rows; i++) {
+    for (int j = 0; j < cols; j++) {
+      a(i, j) = (i * 13 + j * 7) % 17 / 3.0;
+      b(i, j) = (i + j) % 5 - 2.5;
+    }
+  }
+  long long threshold = S21Matrix::GetParallelThreshold();
+  S21Matrix column_x(rows, 1), column_y(cols, 1);
+  for (int i = 0; i < rows; i++) column_x(i, 0) = a(i, 0) - 1;
+  for (int j = 0; j < cols; j++) column_y(j, 0) = b(0, j) / 3;
+  S21Matrix expected[7];
+  for (int pass = 0; pass < 2; pass++) {
+    S21Matrix::SetParallelThreshold(pass == 0 ? 1LL << 40 : 1);
+    S21Matrix copy(a);
+    S21Matrix results[7] = {copy, copy, copy, copy.Transpose(),
+                            copy, copy, copy};
+    results[0].SumMatrix(b);
+    results[1].SubMatrix(b);
+    results[2].MulNumber(-1.5);
+    results[4].Axpy(0.25, b);
+    results[5].Scal(3);
+    results[6].Ger(-2, column_x, column_y);
+    for (int r = 0; r < 7; r++) {
+      if (pass == 0)
+        expected[r] = results[r];
+      else
+        EXPECT_EQ(MaxAbsDiff(results[r], expected[r]), 0);
+    }
+  }
+  S21Matrix::SetParallelThreshold(threshold);
+  EXPECT_EQ(expected[3](169, 299), a(299, 169));
+  EXPECT_EQ(S21Allocator::GetParallelTouchBytes(),
+            static_cast<std::size_t>(threshold) * sizeof(double));
+  EXPECT_THROW(S21Matrix::SetParallelThreshold(0), std::length_error);
+}
+
+TEST(LargeIndex, AllocationSizeIsChecked) {
+  EXPECT_THROW(S21Matrix(1LL << 40, 1LL << 40), std::length_error);
+  EXPECT_THROW(S21Matrix(1LL << 61, 2), std::length_error);
+  S21Matrix matrix(3, 4);
+  EXPECT_THROW(matrix.Reserve(1LL << 33, 1LL << 33), std::length_error);
+  EXPECT_EQ(matrix.GetRows64(), 3);
+  EXPECT_EQ(matrix.GetCols64(), 4);
+}
+
+TEST(LargeIndex, IntGettersAreChecked) {
+  double cell = 0;
+  S21Matrix tall = S21Matrix::Borrow(&cell, 1LL << 32, 0);
+  EXPECT_EQ(tall.GetRows64(), 1LL << 32);
+  EXPECT_EQ(tall.GetCols(), 0);
+  EXPECT_THROW(tall.GetRows(), std::length_error);
+  S21Buffer buffer = tall.Release();
+  EXPECT_EQ(buffer.rows, 1LL << 32);
+  EXPECT_EQ(buffer.data, &cell);
+}
+
+TEST(LargeIndex, OffsetsAbove2To31) {
+  // память резервируется без записи, страницы выделяются только при касании
+  const long long big = (1LL << 31) + 64;
+  void* memory = mmap(nullptr, static_cast<size_t>(big) * sizeof(double),
+                      PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  ASSERT_NE(memory, MAP_FAILED);
+  double* data = static_cast<double*>(memory);
+  {
+    S21Matrix column = S21Matrix::Borrow(data, big, 1);
+    EXPECT_EQ(column.GetRows64(), big);
+    EXPECT_THROW(column.GetRows(), std::length_error);
+    column(big - 1, 0) = 7;
+    EXPECT_EQ(data[big - 1], 7);
+    // две строки с шагом больше 2^31 элементов
+    S21Matrix rows = S21Matrix::Borrow(data, 2, 1, big - 1);
+    rows.Ger(2, S21Vector({1, 3}), S21Vector({1}));
+    EXPECT_EQ(rows(0, 0), 2);
+    EXPECT_EQ(rows(1, 0), 13);
+  }
+  munmap(memory, static_cast<size_t>(big) * sizeof(double));
+}
+
 TEST(print, matrix) {
   S21Matrix matrix1(3, 3);
   int count = 1;
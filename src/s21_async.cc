@@ -0,0 +1,69 @@
+#include "s21_async.h"
+
+#include <algorithm>
+
+namespace {
+
+// Лимит незавершённых операций общего исполнителя
+constexpr int kDefaultMaxPending = 64;
+
+}  // namespace
+
+S21CancellationToken::S21CancellationToken()
+    : cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+
+void S21CancellationToken::Cancel() noexcept { *cancelled_ = true; }
+
+bool S21CancellationToken::IsCancelled() const noexcept { return *cancelled_; }
+
+S21AsyncExecutor::S21AsyncExecutor(int max_pending, S21ThreadPool& pool)
+    : pool_(pool), max_pending_(std::max(1, max_pending)), pending_(0) {}
+
+/// @brief Деструктор дожидается завершения всех поставленных операций
+S21AsyncExecutor::~S21AsyncExecutor() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  slot_freed_.wait(lock, [this] { return pending_ == 0; });
+}
+
+/// @brief Общий исполнитель библиотеки, работающий в общем пуле потоков
+S21AsyncExecutor& S21AsyncExecutor::Instance() {
+  static S21AsyncExecutor executor(kDefaultMaxPending);
+  return executor;
+}
+
+int S21AsyncExecutor::GetPending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_;
+}
+
+int S21AsyncExecutor::GetMaxPending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return max_pending_;
+}
+
+void S21AsyncExecutor::SetMaxPending(int max_pending) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_pending_ = std::max(1, max_pending);
+  }
+  slot_freed_.notify_all();
+}
+
+/// @brief Занимает место под операцию, при необходимости дожидаясь его
+/// @return false, если мест нет, а вызов идёт из рабочего потока пула:
+/// тогда операция выполняется сразу и место не занимает
+bool S21AsyncExecutor::AcquireSlot() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (pending_ >= max_pending_ && pool_.IsWorkerThread()) return false;
+  slot_freed_.wait(lock, [this] { return pending_ < max_pending_; });
+  ++pending_;
+  return true;
+}
+
+/// @brief Освобождает место под операцию. Оповещение идёт под мьютексом,
+/// чтобы деструктор не завершился раньше него
+void S21AsyncExecutor::ReleaseSlot() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  --pending_;
+  slot_freed_.notify_all();
+}
@@ -0,0 +1,100 @@
+#ifndef S21_ASYNC
+#define S21_ASYNC
+
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+
+#include "s21_thread_pool.h"
+
+/// @brief Исключение, которое получает future отменённой операции
+class S21OperationCancelled : public std::runtime_error {
+ public:
+  S21OperationCancelled() : std::runtime_error("операция отменена") {}
+};
+
+/// @brief Токен отмены. Копии токена разделяют одно состояние, поэтому
+/// отменить операцию можно через любую из них
+class S21CancellationToken {
+ public:
+  S21CancellationToken();
+
+  void Cancel() noexcept;
+  bool IsCancelled() const noexcept;
+
+ private:
+  std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+/// @brief Исполнитель асинхронных операций поверх пула потоков с
+/// ограниченным числом незавершённых операций: когда лимит исчерпан, Submit
+/// блокирует вызывающий поток до освобождения места. Рабочий поток пула не
+/// ждёт (место может освободить только другой рабочий поток, и все они
+/// могли бы ждать друг друга), а выполняет операцию сразу сам
+class S21AsyncExecutor {
+ public:
+  explicit S21AsyncExecutor(
+      int max_pending, S21ThreadPool& pool = S21ThreadPool::Instance());
+  S21AsyncExecutor(const S21AsyncExecutor&) = delete;
+  S21AsyncExecutor& operator=(const S21AsyncExecutor&) = delete;
+  ~S21AsyncExecutor();
+
+  static S21AsyncExecutor& Instance();
+
+  template <typename F>
+  auto Submit(F function, S21CancellationToken token = S21CancellationToken())
+      -> std::future<decltype(function())>;
+
+  int GetPending() const;
+  int GetMaxPending() const;
+  void SetMaxPending(int max_pending);
+
+ private:
+  bool AcquireSlot();
+  void ReleaseSlot();
+
+  S21ThreadPool& pool_;
+  mutable std::mutex mutex_;
+  std::condition_variable slot_freed_;
+  int max_pending_;
+  int pending_;
+};
+
+/// @brief Ставит функцию в пул и возвращает future с её результатом.
+/// Операция, отменённая до начала выполнения, не запускается, а future
+/// получает исключение S21OperationCancelled
+template <typename F>
+auto S21AsyncExecutor::Submit(F function, S21CancellationToken token)
+    -> std::future<decltype(function())> {
+  using Result = decltype(function());
+  auto promise = std::make_shared<std::promise<Result>>();
+  std::future<Result> future = promise->get_future();
+  auto operation = [promise, token, function = std::move(function)] {
+    try {
+      if (token.IsCancelled()) throw S21OperationCancelled();
+      if constexpr (std::is_void_v<Result>) {
+        function();
+        promise->set_value();
+      } else {
+        promise->set_value(function());
+      }
+    } catch (...) {
+      promise->set_exception(std::current_exception());
+    }
+  };
+  if (!AcquireSlot()) {
+    operation();
+    return future;
+  }
+  pool_.Submit([this, operation = std::move(operation)] {
+    operation();
+    ReleaseSlot();
+  });
+  return future;
+}
+
+#endif  // S21_ASYNC
@@ -0,0 +1,643 @@
+#include "s21_distributed.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <numeric>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "s21_kernels.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Число барьеров в сегменте: по одному на группу каждого Split
+constexpr int kMaxBarriers = 1024;
+constexpr std::size_t kAlign = 64;
+// Ширина панели общей размерности в SUMMA
+constexpr int kPanel = 256;
+
+static_assert(std::atomic<int>::is_always_lock_free,
+              "барьеры в общей памяти требуют атомарных int без блокировок");
+
+std::size_t AlignUp(std::size_t bytes) {
+  return (bytes + kAlign - 1) / kAlign * kAlign;
+}
+
+// Потоки, следящие за дочерними процессами выполняющихся в этом процессе Run
+std::atomic<int> watchers(0);
+
+/// @brief Число потоков текущего процесса или -1, если его не узнать
+int ProcessThreads() {
+  DIR* dir = opendir("/proc/self/task");
+  if (dir == nullptr) return -1;
+  int threads = 0;
+  while (dirent* entry = readdir(dir))
+    if (entry->d_name[0] != '.') ++threads;
+  closedir(dir);
+  return threads;
+}
+
+}  // namespace
+
+/// @brief Общий сегмент группы процессов: флаг аварийного завершения,
+/// счётчик выделенных барьеров, барьеры, таблица для Split и буферы рассылки
+/// каждого процесса. Новый сегмент заполнен нулями, что и является
+/// начальным состоянием всех счётчиков
+class S21ShmSegment {
+ public:
+  S21ShmSegment(const std::string& name, int size, std::size_t buffer_bytes);
+  S21ShmSegment(const S21ShmSegment&) = delete;
+  S21ShmSegment& operator=(const S21ShmSegment&) = delete;
+  ~S21ShmSegment();
+
+  struct Entry {
+    int color;
+    int key;
+    int base;
+  };
+
+  void Wait(int barrier, int members);
+  int ReserveBarriers(int count) noexcept;
+  void Abort() noexcept { header_->aborted.store(1); }
+  Entry* Table() const noexcept { return table_; }
+  char* Buffer(int process) const noexcept {
+    return buffers_ + process * buffer_bytes_;
+  }
+  std::size_t BufferBytes() const noexcept { return buffer_bytes_; }
+
+ private:
+  struct Header {
+    std::atomic<int> aborted;
+    std::atomic<int> next_barrier;
+  };
+  struct alignas(kAlign) BarrierSlot {
+    std::atomic<int> count;
+    std::atomic<int> generation;
+  };
+
+  void* base_;
+  std::size_t bytes_;
+  std::size_t buffer_bytes_;
+  Header* header_;
+  BarrierSlot* barriers_;
+  Entry* table_;
+  char* buffers_;
+};
+
+S21ShmSegment::S21ShmSegment(const std::string& name, int size,
+                             std::size_t buffer_bytes)
+    : buffer_bytes_(AlignUp(buffer_bytes)) {
+  if (size < 1 || buffer_bytes == 0)
+    throw std::length_error("Недопустимый размер группы процессов");
+  std::size_t header = AlignUp(sizeof(Header));
+  std::size_t barriers = sizeof(BarrierSlot) * kMaxBarriers;
+  std::size_t table = AlignUp(sizeof(Entry) * size);
+  bytes_ = header + barriers + table + buffer_bytes_ * size;
+
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+  if (fd < 0)
+    throw std::system_error(errno, std::generic_category(),
+                            "не удалось открыть общую память " + name);
+  if (ftruncate(fd, bytes_) != 0) {
+    int error = errno;
+    close(fd);
+    throw std::system_error(error, std::generic_category(),
+                            "не удалось задать размер общей памяти");
+  }
+  base_ = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  int error = errno;
+  close(fd);
+  if (base_ == MAP_FAILED)
+    throw std::system_error(error, std::generic_category(),
+                            "не удалось отобразить общую память");
+  char* data = static_cast<char*>(base_);
+  header_ = reinterpret_cast<Header*>(data);
+  barriers_ = reinterpret_cast<BarrierSlot*>(data + header);
+  table_ = reinterpret_cast<Entry*>(data + header + barriers);
+  buffers_ = data + header + barriers + table;
+}
+
+S21ShmSegment::~S21ShmSegment() { munmap(base_, bytes_); }
+
+/// @brief Барьер со счётчиком поколений: последний пришедший обнуляет
+/// счётчик и переключает поколение, остальные ждут переключения. Ожидание
+/// прерывается исключением, если другой процесс группы завершился с ошибкой
+void S21ShmSegment::Wait(int barrier, int members) {
+  if (header_->aborted.load(std::memory_order_acquire))
+    throw std::runtime_error("процесс группы завершился с ошибкой");
+  if (members == 1) return;
+  BarrierSlot& slot = barriers_[barrier];
+  int generation = slot.generation.load(std::memory_order_acquire);
+  if (slot.count.fetch_add(1, std::memory_order_acq_rel) + 1 == members) {
+    slot.count.store(0, std::memory_order_relaxed);
+    slot.generation.fetch_add(1, std::memory_order_release);
+    return;
+  }
+  while (slot.generation.load(std::memory_order_acquire) == generation) {
+    if (header_->aborted.load(std::memory_order_acquire))
+      throw std::runtime_error("процесс группы завершился с ошибкой");
+    sched_yield();
+  }
+}
+
+/// @brief Выделяет count барьеров подряд
+/// @return номер первого барьера или -1, если барьеры закончились
+int S21ShmSegment::ReserveBarriers(int count) noexcept {
+  // Барьер 0 принадлежит всей группе
+  int base = 1 + header_->next_barrier.fetch_add(count);
+  return base + count <= kMaxBarriers ? base : -1;
+}
+
+/// @brief Подключение процесса rank к группе из size процессов через
+/// сегмент общей памяти name. Конструктор коллективный: он ждёт, пока
+/// подключатся все процессы, после чего имя сегмента удаляется
+S21ShmCommunicator::S21ShmCommunicator(const std::string& name, int rank,
+                                       int size, std::size_t buffer_bytes)
+    : segment_(std::make_shared<S21ShmSegment>(name, size, buffer_bytes)),
+      members_(size),
+      rank_(rank),
+      barrier_(0) {
+  if (rank < 0 || rank >= size)
+    throw std::length_error("номер процесса за пределами группы");
+  std::iota(members_.begin(), members_.end(), 0);
+  Barrier();
+  if (rank_ == 0) shm_unlink(name.c_str());
+}
+
+S21ShmCommunicator::S21ShmCommunicator(std::shared_ptr<S21ShmSegment> segment,
+                                       std::vector<int> members, int rank,
+                                       int barrier)
+    : segment_(std::move(segment)),
+      members_(std::move(members)),
+      rank_(rank),
+      barrier_(barrier) {}
+
+S21ShmCommunicator::~S21ShmCommunicator() = default;
+
+/// @brief Запускает body в processes процессах: текущий процесс получает
+/// номер 0, остальные порождаются fork() и завершаются после body. Ошибка
+/// любого процесса прерывает ожидание у остальных и пробрасывается отсюда.
+/// Дочерний процесс наследует только вызвавший fork() поток, и блокировка,
+/// которую держал другой поток, осталась бы в нём захваченной навсегда.
+/// Поэтому кроме вызывающего в процессе могут работать только рабочие потоки
+/// общего пула, которые на время fork() усыпляются без задач, и потоки
+/// внешних Run; иначе, как и при вызове из рабочего потока, бросается
+/// std::logic_error
+void S21ShmCommunicator::Run(
+    int processes, const std::function<void(S21Communicator&)>& body,
+    std::size_t buffer_bytes) {
+  if (processes < 1)
+    throw std::length_error("число процессов должно быть положительным");
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  if (pool.IsWorkerThread())
+    throw std::logic_error("группу процессов нельзя запускать из задачи пула");
+  int threads = ProcessThreads();
+  if (threads > 1 + pool.LiveWorkers() + watchers)
+    throw std::logic_error(
+        "группу процессов можно запускать только из единственного потока");
+  static std::atomic<int> counter(0);
+  std::string name = "/s21_comm_" + std::to_string(getpid()) + "_" +
+                     std::to_string(counter++);
+  // Сегмент создаётся до fork(), и процессы группы наследуют отображение,
+  // поэтому подключение к группе не может сорваться в дочернем процессе
+  auto segment =
+      std::make_shared<S21ShmSegment>(name, processes, buffer_bytes);
+  shm_unlink(name.c_str());
+  std::vector<int> members(processes);
+  std::iota(members.begin(), members.end(), 0);
+
+  std::vector<pid_t> children;
+  std::exception_ptr error;
+  std::unique_lock<std::mutex> paused = pool.Quiesce();
+  for (int rank = 1; rank < processes && !error; ++rank) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      if (paused.owns_lock()) paused.unlock();
+      watchers = 0;
+      int status = 0;
+      try {
+        S21ShmCommunicator comm(segment, members, rank, 0);
+        body(comm);
+      } catch (...) {
+        segment->Abort();
+        status = 1;
+      }
+      _exit(status);
+    }
+    if (pid < 0)
+      error = std::make_exception_ptr(std::system_error(
+          errno, std::generic_category(), "не удалось создать процесс"));
+    else
+      children.push_back(pid);
+  }
+  if (paused.owns_lock()) paused.unlock();
+
+  // Процесс, завершившийся без исключения (например, по сигналу), сам не
+  // выставит флаг ошибки, поэтому за дочерними процессами следит отдельный
+  // поток и прерывает ожидание у остальных
+  std::atomic<bool> failed(false);
+  ++watchers;
+  std::thread watcher([&children, &segment, &failed] {
+    std::vector<pid_t> running = children;
+    while (!running.empty()) {
+      for (auto it = running.begin(); it != running.end();) {
+        int status = 0;
+        pid_t done = waitpid(*it, &status, WNOHANG);
+        if (done == 0 || (done < 0 && errno == EINTR)) {
+          ++it;
+          continue;
+        }
+        if (done < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+          failed = true;
+          segment->Abort();
+        }
+        it = running.erase(it);
+      }
+      if (!running.empty())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+
+  if (!error) {
+    try {
+      S21ShmCommunicator comm(segment, members, 0, 0);
+      body(comm);
+    } catch (...) {
+      error = std::current_exception();
+    }
+  }
+  if (error) {
+    segment->Abort();
+    for (pid_t child : children) kill(child, SIGKILL);
+  }
+  watcher.join();
+  --watchers;
+  if (error) std::rethrow_exception(error);
+  if (failed) throw std::runtime_error("процесс группы завершился с ошибкой");
+}
+
+int S21ShmCommunicator::Rank() const noexcept { return rank_; }
+
+int S21ShmCommunicator::Size() const noexcept {
+  return static_cast<int>(members_.size());
+}
+
+void S21ShmCommunicator::Barrier() { segment_->Wait(barrier_, Size()); }
+
+/// @brief Рассылка кусками размером с буфер процесса root: root копирует
+/// кусок в свой буфер, после барьера остальные копируют его себе, второй
+/// барьер освобождает буфер для следующего куска
+void S21ShmCommunicator::Broadcast(void* data, std::size_t bytes, int root) {
+  if (root < 0 || root >= Size())
+    throw std::length_error("номер процесса за пределами группы");
+  if (Size() == 1) return;
+  char* buffer = segment_->Buffer(members_[root]);
+  char* target = static_cast<char*>(data);
+  for (std::size_t offset = 0; offset < bytes;
+       offset += segment_->BufferBytes()) {
+    std::size_t chunk = std::min(segment_->BufferBytes(), bytes - offset);
+    if (rank_ == root) std::memcpy(buffer, target + offset, chunk);
+    Barrier();
+    if (rank_ != root) std::memcpy(target + offset, buffer, chunk);
+    Barrier();
+  }
+}
+
+/// @brief Буфер каждого процесса делится на Size() ячеек, по одной на
+/// получателя. За раунд отправитель кладёт в ячейку получателя очередной
+/// кусок его части, после барьера получатели забирают куски из ячеек со своим
+/// номером, второй барьер освобождает ячейки. Число раундов определяется самой
+/// длинной частью во всей группе, поэтому перед обменом процессы сообщают
+/// друг другу свои длины
+void S21ShmCommunicator::AllToAll(const void* send,
+                                  const std::size_t* send_bytes, void* recv,
+                                  const std::size_t* recv_bytes) {
+  int size = Size();
+  const char* source = static_cast<const char*>(send);
+  char* target = static_cast<char*>(recv);
+  std::vector<std::size_t> send_offset(size + 1), recv_offset(size + 1);
+  for (int r = 0; r < size; ++r) {
+    send_offset[r + 1] = send_offset[r] + send_bytes[r];
+    recv_offset[r + 1] = recv_offset[r] + recv_bytes[r];
+  }
+  std::memcpy(target + recv_offset[rank_], source + send_offset[rank_],
+              std::min(send_bytes[rank_], recv_bytes[rank_]));
+  if (size == 1) return;
+  std::size_t cell = segment_->BufferBytes() / size;
+  if (cell == 0)
+    throw std::length_error("буфер общей памяти меньше числа процессов");
+
+  char* buffer = segment_->Buffer(members_[rank_]);
+  std::size_t longest = 0;
+  for (int r = 0; r < size; ++r)
+    if (r != rank_)
+      longest = std::max({longest, send_bytes[r], recv_bytes[r]});
+  std::memcpy(buffer, &longest, sizeof(longest));
+  Barrier();
+  for (int r = 0; r < size; ++r) {
+    std::size_t other;
+    std::memcpy(&other, segment_->Buffer(members_[r]), sizeof(other));
+    longest = std::max(longest, other);
+  }
+  Barrier();
+
+  for (std::size_t offset = 0; offset < longest; offset += cell) {
+    for (int r = 0; r < size; ++r)
+      if (r != rank_ && offset < send_bytes[r])
+        std::memcpy(buffer + r * cell, source + send_offset[r] + offset,
+                    std::min(cell, send_bytes[r] - offset));
+    Barrier();
+    for (int r = 0; r < size; ++r)
+      if (r != rank_ && offset < recv_bytes[r])
+        std::memcpy(target + recv_offset[r] + offset,
+                    segment_->Buffer(members_[r]) + rank_ * cell,
+                    std::min(cell, recv_bytes[r] - offset));
+    Barrier();
+  }
+}
+
+/// @brief Участники записывают color и key в общую таблицу, процесс 0
+/// выделяет по барьеру на каждый цвет, после чего каждый собирает свою
+/// подгруппу. Подгруппы используют буферы того же сегмента
+std::unique_ptr<S21Communicator> S21ShmCommunicator::Split(int color,
+                                                           int key) {
+  S21ShmSegment::Entry* table = segment_->Table();
+  table[members_[rank_]].color = color;
+  table[members_[rank_]].key = key;
+  Barrier();
+
+  std::vector<int> colors;
+  for (int member : members_) colors.push_back(table[member].color);
+  std::sort(colors.begin(), colors.end());
+  colors.erase(std::unique(colors.begin(), colors.end()), colors.end());
+  if (rank_ == 0)
+    table[members_[0]].base =
+        segment_->ReserveBarriers(static_cast<int>(colors.size()));
+  Barrier();
+
+  int base = table[members_[0]].base;
+  std::vector<std::pair<int, int>> group;  // (key, номер в группе)
+  for (int r = 0; r < Size(); ++r)
+    if (table[members_[r]].color == color)
+      group.emplace_back(table[members_[r]].key, r);
+  Barrier();
+  if (base < 0) throw std::runtime_error("закончились барьеры общей памяти");
+
+  std::sort(group.begin(), group.end());
+  std::vector<int> members;
+  int rank = 0;
+  for (std::size_t i = 0; i < group.size(); ++i) {
+    if (group[i].second == rank_) rank = static_cast<int>(i);
+    members.push_back(members_[group[i].second]);
+  }
+  int index = static_cast<int>(
+      std::lower_bound(colors.begin(), colors.end(), color) - colors.begin());
+  return std::unique_ptr<S21Communicator>(new S21ShmCommunicator(
+      segment_, std::move(members), rank, base + index));
+}
+
+/// @brief Помечает группу как аварийно завершённую: ожидающие в барьерах
+/// процессы получат исключение
+void S21ShmCommunicator::Abort() noexcept { segment_->Abort(); }
+
+/// @brief Решётка rows x cols, где rows - наибольший делитель числа
+/// процессов, не превосходящий корня из него. Конструктор коллективный
+S21ProcessGrid::S21ProcessGrid(S21Communicator& comm) : world_(comm) {
+  int size = comm.Size();
+  rows_ = 1;
+  for (int r = 1; r * r <= size; ++r)
+    if (size % r == 0) rows_ = r;
+  cols_ = size / rows_;
+  row_ = comm.Rank() / cols_;
+  col_ = comm.Rank() % cols_;
+  row_comm_ = comm.Split(row_, col_);
+  col_comm_ = comm.Split(col_, row_);
+  if (rows_ == cols_)
+    pair_comm_ =
+        comm.Split(std::min(row_, col_) * cols_ + std::max(row_, col_), row_);
+}
+
+S21DistributedMatrix::S21DistributedMatrix(const S21ProcessGrid& grid,
+                                           int rows, int cols)
+    : grid_(&grid),
+      rows_(rows),
+      cols_(cols),
+      local_(std::max(0, RowEnd() - RowBegin()),
+             std::max(0, ColEnd() - ColBegin())) {
+  if (rows < 0 || cols < 0)
+    throw std::length_error(
+        "число столбцов и строк не может быть отрицательным");
+}
+
+/// @brief Каждый процесс берёт свой блок из имеющейся у него целой матрицы
+S21DistributedMatrix::S21DistributedMatrix(const S21ProcessGrid& grid,
+                                           const S21Matrix& global)
+    : S21DistributedMatrix(grid, global.GetRows(), global.GetCols()) {
+  int cols = ColEnd() - ColBegin();
+  for (int i = RowBegin(); i < RowEnd(); ++i) {
+    const double* row = global.Row(i) + ColBegin();
+    std::copy(row, row + cols, local_.Row(i - RowBegin()));
+  }
+}
+
+int S21DistributedMatrix::RowBegin() const noexcept {
+  return Bound(rows_, grid_->Rows(), grid_->Row());
+}
+
+int S21DistributedMatrix::RowEnd() const noexcept {
+  return Bound(rows_, grid_->Rows(), grid_->Row() + 1);
+}
+
+int S21DistributedMatrix::ColBegin() const noexcept {
+  return Bound(cols_, grid_->Cols(), grid_->Col());
+}
+
+int S21DistributedMatrix::ColEnd() const noexcept {
+  return Bound(cols_, grid_->Cols(), grid_->Col() + 1);
+}
+
+/// @brief Начало части part из parts при разбиении size почти поровну
+int S21DistributedMatrix::Bound(int size, int parts, int part) noexcept {
+  return static_cast<int>(static_cast<long long>(size) * part / parts);
+}
+
+/// @brief Непрерывная копия части локального блока
+std::vector<double> S21DistributedMatrix::Pack(int row, int rows, int col,
+                                               int cols) const {
+  std::vector<double> block(static_cast<std::size_t>(rows) * cols);
+  for (std::int64_t i = 0; i < rows; ++i) {
+    const double* source = local_.Row(row + i) + col;
+    std::copy(source, source + cols, block.begin() + i * cols);
+  }
+  return block;
+}
+
+/// @brief Собирает целую матрицу на всех процессах: блоки по очереди
+/// рассылаются всей группе
+S21Matrix S21DistributedMatrix::Gather() const {
+  S21Matrix result(rows_, cols_);
+  S21Communicator& world = grid_->World();
+  for (int source = 0; source < world.Size(); ++source) {
+    int p = source / grid_->Cols(), q = source % grid_->Cols();
+    int row = Bound(rows_, grid_->Rows(), p);
+    int rows = Bound(rows_, grid_->Rows(), p + 1) - row;
+    int col = Bound(cols_, grid_->Cols(), q);
+    int cols = Bound(cols_, grid_->Cols(), q + 1) - col;
+    std::vector<double> block =
+        source == world.Rank()
+            ? Pack(0, rows, 0, cols)
+            : std::vector<double>(static_cast<std::size_t>(rows) * cols);
+    world.Broadcast(block.data(), block.size() * sizeof(double), source);
+    for (std::int64_t i = 0; i < rows; ++i)
+      std::copy(block.begin() + i * cols, block.begin() + (i + 1) * cols,
+                result.Row(row + i) + col);
+  }
+  return result;
+}
+
+/// @brief Умножение SUMMA: общая размерность делится на панели так, чтобы
+/// панель целиком лежала в одном столбце решётки у this и в одной строке
+/// решётки у other. Владельцы рассылают панель this по строке решётки и
+/// панель other по столбцу, и каждый процесс добавляет их произведение к
+/// своему блоку результата
+S21DistributedMatrix S21DistributedMatrix::MulMatrix(
+    const S21DistributedMatrix& other) const {
+  if (grid_ != other.grid_)
+    throw std::invalid_argument("матрицы распределены по разным решёткам");
+  if (cols_ != other.rows_)
+    throw std::length_error(
+        "число столбцов первой матрицы не равно числу строк второй матрицы");
+  S21DistributedMatrix result(*grid_, rows_, other.cols_);
+  int rows = RowEnd() - RowBegin();
+  int cols = other.ColEnd() - other.ColBegin();
+
+  std::vector<int> bounds;
+  for (int q = 0; q <= grid_->Cols(); ++q)
+    bounds.push_back(Bound(cols_, grid_->Cols(), q));
+  for (int p = 0; p <= grid_->Rows(); ++p)
+    bounds.push_back(Bound(cols_, grid_->Rows(), p));
+  std::sort(bounds.begin(), bounds.end());
+  bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+  int owner_col = 0, owner_row = 0;
+  for (std::size_t b = 0; b + 1 < bounds.size(); ++b) {
+    while (Bound(cols_, grid_->Cols(), owner_col + 1) <= bounds[b])
+      ++owner_col;
+    while (Bound(cols_, grid_->Rows(), owner_row + 1) <= bounds[b])
+      ++owner_row;
+    for (int k = bounds[b]; k < bounds[b + 1]; k += kPanel) {
+      int width = std::min(kPanel, bounds[b + 1] - k);
+      std::vector<double> a =
+          grid_->Col() == owner_col
+              ? Pack(0, rows, k - ColBegin(), width)
+              : std::vector<double>(static_cast<std::size_t>(rows) * width);
+      grid_->RowComm().Broadcast(a.data(), a.size() * sizeof(double),
+                                 owner_col);
+      std::vector<double> b_panel =
+          grid_->Row() == owner_row
+              ? other.Pack(k - other.RowBegin(), width, 0, cols)
+              : std::vector<double>(static_cast<std::size_t>(width) * cols);
+      grid_->ColComm().Broadcast(b_panel.data(),
+                                 b_panel.size() * sizeof(double), owner_row);
+      if (rows > 0 && cols > 0)
+        s21_kernels::Gemm(rows, cols, width, 1.0, a.data(), width, false,
+                          b_panel.data(), cols, false, 1.0,
+                          result.local_.Row(0), result.local_.cols_capacity_);
+    }
+  }
+  return result;
+}
+
+/// @brief Транспонирование. На квадратной решётке блок (p, q) результата -
+/// транспонированный блок (q, p), и процессы обмениваются блоками попарно.
+/// На прямоугольной каждый процесс отправляет другому только пересечение
+/// своего блока с его блоком результата, уже транспонированное
+S21DistributedMatrix S21DistributedMatrix::Transpose() const {
+  S21DistributedMatrix result(*grid_, cols_, rows_);
+  int row = result.RowBegin(), rows = result.RowEnd() - row;
+  int col = result.ColBegin(), cols = result.ColEnd() - col;
+
+  if (grid_->pair_comm_ != nullptr) {
+    // Блок (q, p) исходной матрицы имеет размер cols x rows
+    std::vector<double> mine =
+        Pack(0, RowEnd() - RowBegin(), 0, ColEnd() - ColBegin());
+    std::vector<double> block = mine;
+    S21Communicator& pair = *grid_->pair_comm_;
+    if (pair.Size() == 2) {
+      block.assign(static_cast<std::size_t>(cols) * rows, 0);
+      for (int root = 0; root < 2; ++root) {
+        std::vector<double>& data = pair.Rank() == root ? mine : block;
+        pair.Broadcast(data.data(), data.size() * sizeof(double), root);
+      }
+    }
+    for (int i = 0; i < rows; ++i)
+      for (std::int64_t j = 0; j < cols; ++j)
+        result.local_.Row(i)[j] = block[j * rows + i];
+    return result;
+  }
+
+  // Пересечение блока source исходной матрицы с блоком target результата в
+  // координатах результата: строки [i_begin, i_end), столбцы [j_begin, j_end)
+  struct Overlap {
+    int i_begin, i_end, j_begin, j_end;
+    std::size_t Size() const {
+      return static_cast<std::size_t>(std::max(0, i_end - i_begin)) *
+             std::max(0, j_end - j_begin);
+    }
+  };
+  auto overlap = [this](int source, int target) {
+    int p = source / grid_->Cols(), q = source % grid_->Cols();
+    int tp = target / grid_->Cols(), tq = target % grid_->Cols();
+    return Overlap{std::max(Bound(cols_, grid_->Rows(), tp),
+                            Bound(cols_, grid_->Cols(), q)),
+                   std::min(Bound(cols_, grid_->Rows(), tp + 1),
+                            Bound(cols_, grid_->Cols(), q + 1)),
+                   std::max(Bound(rows_, grid_->Cols(), tq),
+                            Bound(rows_, grid_->Rows(), p)),
+                   std::min(Bound(rows_, grid_->Cols(), tq + 1),
+                            Bound(rows_, grid_->Rows(), p + 1))};
+  };
+
+  S21Communicator& world = grid_->World();
+  int size = world.Size(), rank = world.Rank();
+  std::vector<double> send, recv;
+  std::vector<std::size_t> send_bytes(size), recv_bytes(size);
+  for (int target = 0; target < size; ++target) {
+    Overlap part = overlap(rank, target);
+    send_bytes[target] = part.Size() * sizeof(double);
+    for (int i = part.i_begin; i < part.i_end; ++i)
+      for (int j = part.j_begin; j < part.j_end; ++j)
+        send.push_back(local_.Row(j - RowBegin())[i - ColBegin()]);
+  }
+  for (int source = 0; source < size; ++source) {
+    std::size_t part = overlap(source, rank).Size();
+    recv_bytes[source] = part * sizeof(double);
+    recv.resize(recv.size() + part);
+  }
+  world.AllToAll(send.data(), send_bytes.data(), recv.data(),
+                 recv_bytes.data());
+
+  std::size_t position = 0;
+  for (int source = 0; source < size; ++source) {
+    Overlap part = overlap(source, rank);
+    for (int i = part.i_begin; i < part.i_end; ++i)
+      for (int j = part.j_begin; j < part.j_end; ++j)
+        result.local_.Row(i - row)[j - col] = recv[position++];
+  }
+  return result;
+}
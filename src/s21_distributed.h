@@ -0,0 +1,128 @@
+#ifndef S21_DISTRIBUTED
+#define S21_DISTRIBUTED
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+/// @brief Коммуникатор группы процессов. Все методы коллективные: их
+/// вызывают все участники группы в одном и том же порядке. Интерфейс
+/// повторяет подмножество MPI, чтобы вместо общей памяти можно было
+/// подключить MPI
+class S21Communicator {
+ public:
+  virtual ~S21Communicator() = default;
+
+  virtual int Rank() const noexcept = 0;
+  virtual int Size() const noexcept = 0;
+  virtual void Barrier() = 0;
+  /// @brief Рассылка bytes байт из data процесса root всем участникам
+  virtual void Broadcast(void* data, std::size_t bytes, int root) = 0;
+  /// @brief Обмен каждого с каждым (аналог MPI_Alltoallv): участнику d
+  /// уходят send_bytes[d] байт, от участника s приходят recv_bytes[s] байт.
+  /// Части для разных участников лежат в send и recv подряд по номерам
+  virtual void AllToAll(const void* send, const std::size_t* send_bytes,
+                        void* recv, const std::size_t* recv_bytes) = 0;
+  /// @brief Разбиение на подгруппы по color, номера внутри подгруппы
+  /// упорядочены по key (аналог MPI_Comm_split)
+  virtual std::unique_ptr<S21Communicator> Split(int color, int key) = 0;
+};
+
+class S21ShmSegment;
+
+/// @brief Коммуникатор процессов одной машины через общую память POSIX
+/// (shm_open). Данные рассылаются через буфер процесса-источника в общем
+/// сегменте, синхронизация - барьерами на атомарных счётчиках
+class S21ShmCommunicator : public S21Communicator {
+ public:
+  static constexpr std::size_t kDefaultBuffer = 1 << 20;
+
+  S21ShmCommunicator(const std::string& name, int rank, int size,
+                     std::size_t buffer_bytes = kDefaultBuffer);
+  ~S21ShmCommunicator() override;
+
+  static void Run(int processes,
+                  const std::function<void(S21Communicator&)>& body,
+                  std::size_t buffer_bytes = kDefaultBuffer);
+
+  int Rank() const noexcept override;
+  int Size() const noexcept override;
+  void Barrier() override;
+  void Broadcast(void* data, std::size_t bytes, int root) override;
+  void AllToAll(const void* send, const std::size_t* send_bytes, void* recv,
+                const std::size_t* recv_bytes) override;
+  std::unique_ptr<S21Communicator> Split(int color, int key) override;
+  void Abort() noexcept;
+
+ private:
+  S21ShmCommunicator(std::shared_ptr<S21ShmSegment> segment,
+                     std::vector<int> members, int rank, int barrier);
+
+  std::shared_ptr<S21ShmSegment> segment_;
+  std::vector<int> members_;  // Номера участников во всём сегменте
+  int rank_;
+  int barrier_;  // Номер барьера группы в сегменте
+};
+
+/// @brief Двумерная решётка процессов rows x cols (близкая к квадратной)
+/// поверх коммуникатора вместе с коммуникаторами строк и столбцов решётки.
+/// Процесс с номером r стоит в строке r / cols и столбце r % cols
+class S21ProcessGrid {
+ public:
+  explicit S21ProcessGrid(S21Communicator& comm);
+
+  S21Communicator& World() const noexcept { return world_; }
+  S21Communicator& RowComm() const noexcept { return *row_comm_; }
+  S21Communicator& ColComm() const noexcept { return *col_comm_; }
+  int Rows() const noexcept { return rows_; }
+  int Cols() const noexcept { return cols_; }
+  int Row() const noexcept { return row_; }
+  int Col() const noexcept { return col_; }
+
+ private:
+  friend class S21DistributedMatrix;
+
+  S21Communicator& world_;
+  int rows_, cols_, row_, col_;
+  std::unique_ptr<S21Communicator> row_comm_;
+  std::unique_ptr<S21Communicator> col_comm_;
+  // Пара процессов (p, q) и (q, p) для транспонирования, только у квадратной
+  // решётки
+  std::unique_ptr<S21Communicator> pair_comm_;
+};
+
+/// @brief Матрица, разбитая на блоки по решётке процессов: процесс (p, q)
+/// хранит строки [RowBegin, RowEnd) и столбцы [ColBegin, ColEnd). Операции
+/// коллективные и вызываются всеми процессами решётки
+class S21DistributedMatrix {
+ public:
+  S21DistributedMatrix(const S21ProcessGrid& grid, int rows, int cols);
+  S21DistributedMatrix(const S21ProcessGrid& grid, const S21Matrix& global);
+
+  int GetRows() const noexcept { return rows_; }
+  int GetCols() const noexcept { return cols_; }
+  int RowBegin() const noexcept;
+  int RowEnd() const noexcept;
+  int ColBegin() const noexcept;
+  int ColEnd() const noexcept;
+  S21Matrix& Local() noexcept { return local_; }
+  const S21Matrix& Local() const noexcept { return local_; }
+
+  S21Matrix Gather() const;
+  S21DistributedMatrix MulMatrix(const S21DistributedMatrix& other) const;
+  S21DistributedMatrix Transpose() const;
+
+ private:
+  static int Bound(int size, int parts, int part) noexcept;
+  std::vector<double> Pack(int row, int rows, int col, int cols) const;
+
+  const S21ProcessGrid* grid_;
+  int rows_, cols_;
+  S21Matrix local_;
+};
+
+#endif  // S21_DISTRIBUTED
@@ -0,0 +1,359 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Наибольшее по модулю целое, которое double хранит точно (2^53)
+constexpr double kMaxExactInteger = 9007199254740992.0;
+// Простые модули для многомодульного счёта берутся меньше 2^31, чтобы
+// произведение двух вычетов помещалось в 64 бита
+constexpr std::uint64_t kPrimeLimit = 1ULL << 31;
+
+using Int128 = __int128;
+
+/// @brief Целое число произвольной длины: только то, что нужно для
+/// восстановления результата по китайской теореме об остатках
+class BigInt {
+ public:
+  explicit BigInt(std::uint64_t value)
+      : limbs_{static_cast<std::uint32_t>(value),
+               static_cast<std::uint32_t>(value >> 32)} {
+    Trim();
+  }
+
+  /// @brief this = this * factor + addend
+  void MulAdd(std::uint32_t factor, std::uint32_t addend) {
+    std::uint64_t carry = addend;
+    for (auto& limb : limbs_) {
+      std::uint64_t value = std::uint64_t(limb) * factor + carry;
+      limb = static_cast<std::uint32_t>(value);
+      carry = value >> 32;
+    }
+    if (carry != 0) limbs_.push_back(static_cast<std::uint32_t>(carry));
+    Trim();
+  }
+
+  int Compare(const BigInt& other) const {
+    if (limbs_.size() != other.limbs_.size())
+      return limbs_.size() < other.limbs_.size() ? -1 : 1;
+    for (std::size_t i = limbs_.size(); i-- > 0;) {
+      if (limbs_[i] != other.limbs_[i])
+        return limbs_[i] < other.limbs_[i] ? -1 : 1;
+    }
+    return 0;
+  }
+
+  /// @brief this = other - this (при other >= this)
+  void SubtractFrom(const BigInt& other) {
+    std::vector<std::uint32_t> result(other.limbs_.size());
+    std::int64_t borrow = 0;
+    for (std::size_t i = 0; i < result.size(); ++i) {
+      std::int64_t value = std::int64_t(other.limbs_[i]) - borrow -
+                           (i < limbs_.size() ? limbs_[i] : 0);
+      borrow = value < 0;
+      result[i] = static_cast<std::uint32_t>(value + (borrow << 32));
+    }
+    limbs_ = std::move(result);
+    Trim();
+  }
+
+  bool FitsInt64(bool negative) const {
+    if (limbs_.size() > 2) return false;
+    std::uint64_t value = limbs_[0];
+    if (limbs_.size() == 2) value |= std::uint64_t(limbs_[1]) << 32;
+    return value <= std::uint64_t(std::numeric_limits<std::int64_t>::max()) +
+                        (negative ? 1 : 0);
+  }
+
+  std::uint64_t Low64() const {
+    std::uint64_t value = limbs_[0];
+    if (limbs_.size() > 1) value |= std::uint64_t(limbs_[1]) << 32;
+    return value;
+  }
+
+  /// @brief Десятичная запись модуля числа
+  std::string ToString() const {
+    std::vector<std::uint32_t> digits = limbs_;
+    std::string result;
+    while (digits.size() > 1 || digits[0] != 0) {
+      std::uint64_t remainder = 0;
+      for (std::size_t i = digits.size(); i-- > 0;) {
+        std::uint64_t value = (remainder << 32) | digits[i];
+        digits[i] = static_cast<std::uint32_t>(value / 1000000000);
+        remainder = value % 1000000000;
+      }
+      while (digits.size() > 1 && digits.back() == 0) digits.pop_back();
+      std::string chunk = std::to_string(remainder);
+      bool last = digits.size() == 1 && digits[0] == 0;
+      if (!last) chunk.insert(0, 9 - chunk.size(), '0');
+      result.insert(0, chunk);
+    }
+    return result.empty() ? "0" : result;
+  }
+
+ private:
+  void Trim() {
+    while (limbs_.size() > 1 && limbs_.back() == 0) limbs_.pop_back();
+  }
+
+  std::vector<std::uint32_t> limbs_;  // Разряды по основанию 2^32, младшие
+                                      // первыми
+};
+
+/// @brief Точный результат: знак и модуль
+struct ExactValue {
+  bool negative;
+  BigInt magnitude;
+};
+
+/// @brief Элементы матрицы как 64-битные целые
+std::vector<std::int64_t> ToIntegers(const S21Matrix& matrix) {
+  std::int64_t rows = matrix.GetRows64(), cols = matrix.GetCols64();
+  std::vector<std::int64_t> result(static_cast<std::size_t>(rows) * cols);
+  for (std::int64_t i = 0; i < rows; ++i) {
+    for (std::int64_t j = 0; j < cols; ++j) {
+      double value = matrix(i, j);
+      if (!(std::fabs(value) <= kMaxExactInteger) ||
+          value != std::trunc(value))
+        throw std::length_error("матрица не является целочисленной");
+      result[i * cols + j] = static_cast<std::int64_t>(value);
+    }
+  }
+  return result;
+}
+
+/// @brief Метод Барейса без дробей: после шага k элемент (i, j) равен
+/// минору порядка k + 1, поэтому деление на прошлый ведущий элемент всегда
+/// нацело. Промежуточное произведение считается в 128 битах. Значения
+/// держатся в симметричном диапазоне [-INT64_MAX, INT64_MAX]: у INT64_MIN нет
+/// противоположного, поэтому он, как и выход за int64, отдаёт счёт модулярному
+/// методу
+/// @param rank если не nullptr, считается ранг прямоугольной матрицы
+/// @return false при выходе значения за пределы int64
+bool Bareiss(std::vector<std::int64_t> a, std::int64_t rows, std::int64_t cols,
+             std::int64_t* det, int* rank) {
+  std::int64_t previous = 1;
+  int sign = 1;
+  std::int64_t row = 0;
+  for (std::int64_t col = 0; col < cols && row < rows; ++col) {
+    std::int64_t pivot = row;
+    while (pivot < rows && a[pivot * cols + col] == 0) ++pivot;
+    if (pivot == rows) {
+      if (rank == nullptr) {
+        *det = 0;
+        return true;
+      }
+      continue;
+    }
+    if (pivot != row) {
+      std::swap_ranges(a.begin() + row * cols, a.begin() + (row + 1) * cols,
+                       a.begin() + pivot * cols);
+      sign = -sign;
+    }
+    std::int64_t lead = a[row * cols + col];
+    for (std::int64_t i = row + 1; i < rows; ++i) {
+      std::int64_t factor = a[i * cols + col];
+      for (std::int64_t j = col + 1; j < cols; ++j) {
+        Int128 value = Int128(a[i * cols + j]) * lead -
+                       Int128(factor) * a[row * cols + j];
+        value /= previous;
+        if (value > std::numeric_limits<std::int64_t>::max() ||
+            value < -std::numeric_limits<std::int64_t>::max())
+          return false;
+        a[i * cols + j] = static_cast<std::int64_t>(value);
+      }
+      a[i * cols + col] = 0;
+    }
+    previous = lead;
+    ++row;
+  }
+  // Ранг не больше меньшего из размеров, квадрат которого не больше числа
+  // элементов, поэтому помещается в int
+  if (rank != nullptr) *rank = static_cast<int>(row);
+  if (det != nullptr) *det = sign * previous;
+  return true;
+}
+
+std::uint64_t PowMod(std::uint64_t base, std::uint64_t exponent,
+                     std::uint64_t p) {
+  std::uint64_t result = 1;
+  for (base %= p; exponent > 0; exponent >>= 1) {
+    if (exponent & 1) result = result * base % p;
+    base = base * base % p;
+  }
+  return result;
+}
+
+/// @brief Обратный по простому модулю (малая теорема Ферма)
+std::uint64_t InverseMod(std::uint64_t value, std::uint64_t p) {
+  return PowMod(value, p - 2, p);
+}
+
+/// @brief Гаусс по модулю p: ранг и определитель (для квадратной матрицы)
+int EliminateMod(const std::vector<std::int64_t>& source, std::int64_t rows,
+                 std::int64_t cols, std::uint64_t p, std::uint64_t* det) {
+  std::vector<std::uint64_t> a(source.size());
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    std::int64_t residue = source[i] % static_cast<std::int64_t>(p);
+    a[i] = residue < 0 ? residue + p : residue;
+  }
+  std::uint64_t product = 1;
+  std::int64_t row = 0;
+  for (std::int64_t col = 0; col < cols && row < rows; ++col) {
+    std::int64_t pivot = row;
+    while (pivot < rows && a[pivot * cols + col] == 0) ++pivot;
+    if (pivot == rows) continue;
+    if (pivot != row) {
+      std::swap_ranges(a.begin() + row * cols, a.begin() + (row + 1) * cols,
+                       a.begin() + pivot * cols);
+      product = p - product;
+    }
+    std::uint64_t lead = a[row * cols + col];
+    product = product * lead % p;
+    std::uint64_t inverse = InverseMod(lead, p);
+    for (std::int64_t i = row + 1; i < rows; ++i) {
+      std::uint64_t factor = a[i * cols + col] * inverse % p;
+      if (factor == 0) continue;
+      for (std::int64_t j = col + 1; j < cols; ++j)
+        a[i * cols + j] =
+            (a[i * cols + j] + (p - factor) * a[row * cols + j]) % p;
+    }
+    ++row;
+  }
+  if (det != nullptr) *det = row == rows && rows == cols ? product % p : 0;
+  return static_cast<int>(row);
+}
+
+/// @brief Оценка Адамара: любой минор не превосходит произведения норм
+/// ненулевых строк. Возвращает двоичный логарифм этой оценки
+double HadamardBits(const std::vector<std::int64_t>& a, std::int64_t rows,
+                    std::int64_t cols) {
+  double bits = 0;
+  for (std::int64_t i = 0; i < rows; ++i) {
+    double norm = 0;
+    for (std::int64_t j = 0; j < cols; ++j)
+      norm += double(a[i * cols + j]) * double(a[i * cols + j]);
+    if (norm > 0) bits += 0.5 * std::log2(norm);
+  }
+  return bits;
+}
+
+/// @brief Простые числа меньше 2^31 по убыванию, произведение которых
+/// больше 2^bits
+std::vector<std::uint64_t> Primes(double bits) {
+  std::vector<std::uint64_t> primes;
+  double total = 0;
+  for (std::uint64_t candidate = kPrimeLimit - 1; total <= bits;
+       candidate -= 2) {
+    bool prime = true;
+    for (std::uint64_t d = 3; d * d <= candidate && prime; d += 2)
+      prime = candidate % d != 0;
+    if (!prime) continue;
+    primes.push_back(candidate);
+    total += std::log2(double(candidate));
+  }
+  return primes;
+}
+
+/// @brief Восстановление числа из вычетов по китайской теореме об остатках
+/// (алгоритм Гарнера) в симметричном диапазоне (-M/2, M/2]
+ExactValue Reconstruct(const std::vector<std::uint64_t>& residues,
+                       const std::vector<std::uint64_t>& primes) {
+  std::size_t count = primes.size();
+  std::vector<std::uint64_t> digits(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    std::uint64_t x = residues[i];
+    for (std::size_t j = 0; j < i; ++j) {
+      x = (x + primes[i] - digits[j] % primes[i]) % primes[i];
+      x = x * InverseMod(primes[j] % primes[i], primes[i]) % primes[i];
+    }
+    digits[i] = x;
+  }
+  BigInt value(digits[count - 1]);
+  BigInt modulus(std::uint64_t(1));
+  for (std::size_t i = count - 1; i-- > 0;)
+    value.MulAdd(static_cast<std::uint32_t>(primes[i]),
+                 static_cast<std::uint32_t>(digits[i]));
+  for (std::uint64_t p : primes)
+    modulus.MulAdd(static_cast<std::uint32_t>(p), 0);
+
+  BigInt doubled = value;
+  doubled.MulAdd(2, 0);
+  if (doubled.Compare(modulus) > 0) {
+    value.SubtractFrom(modulus);
+    return {true, value};
+  }
+  return {false, value};
+}
+
+/// @brief Точный определитель: метод Барейса в int64, а при переполнении -
+/// по модулям нескольких простых (параллельно в пуле потоков) с
+/// восстановлением по китайской теореме об остатках
+ExactValue ExactDeterminant(const S21Matrix& matrix) {
+  int n = matrix.GetRows();
+  std::vector<std::int64_t> a = ToIntegers(matrix);
+  std::int64_t det = 0;
+  if (Bareiss(a, n, n, &det, nullptr)) {
+    bool negative = det < 0;
+    std::uint64_t magnitude =
+        negative ? 0 - static_cast<std::uint64_t>(det) : det;
+    return {negative, BigInt(magnitude)};
+  }
+
+  std::vector<std::uint64_t> primes = Primes(HadamardBits(a, n, n) + 1);
+  std::vector<std::uint64_t> residues(primes.size());
+  S21ThreadPool::Instance().ParallelFor(
+      0, static_cast<int>(primes.size()), [&](int from, int to) {
+        for (int i = from; i < to; ++i)
+          EliminateMod(a, n, n, primes[i], &residues[i]);
+      });
+  return Reconstruct(residues, primes);
+}
+
+}  // namespace
+
+/// @brief Точный определитель целочисленной матрицы за O(n^3)
+/// @return значение, если оно помещается в int64, иначе std::overflow_error
+/// (полное значение возвращает DeterminantExact)
+std::int64_t S21Matrix::DeterminantInt() const {
+  if (cols_ != rows_) throw std::length_error("матрица не является квадратной");
+  CheckMatrix(*this);
+  ExactValue det = ExactDeterminant(*this);
+  if (!det.magnitude.FitsInt64(det.negative))
+    throw std::overflow_error("определитель не помещается в int64");
+  std::uint64_t magnitude = det.magnitude.Low64();
+  return static_cast<std::int64_t>(det.negative ? 0 - magnitude : magnitude);
+}
+
+/// @brief Точный определитель целочисленной матрицы любой величины в
+/// десятичной записи
+std::string S21Matrix::DeterminantExact() const {
+  if (cols_ != rows_) throw std::length_error("матрица не является квадратной");
+  CheckMatrix(*this);
+  ExactValue det = ExactDeterminant(*this);
+  return (det.negative ? "-" : "") + det.magnitude.ToString();
+}
+
+/// @brief Точный ранг целочисленной матрицы. При переполнении int64 ранг
+/// считается по модулям простых, произведение которых больше оценки
+/// Адамара для всех миноров, поэтому ни один ненулевой минор не обнулится
+/// по всем модулям сразу
+int S21Matrix::RankExact() const {
+  CheckMatrix(*this);
+  std::vector<std::int64_t> a = ToIntegers(*this);
+  int rank = 0;
+  if (Bareiss(a, rows_, cols_, nullptr, &rank)) return rank;
+
+  std::vector<std::uint64_t> primes = Primes(HadamardBits(a, rows_, cols_));
+  for (std::uint64_t p : primes)
+    rank = std::max(rank, EliminateMod(a, rows_, cols_, p, nullptr));
+  return rank;
+}
@@ -0,0 +1,172 @@
+#include "s21_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace s21_kernels {
+
+namespace {
+
+// Число независимых сумматоров скалярного произведения и сумм: разрывает
+// цепочку зависимостей сложений и позволяет компилятору разложить цикл по
+// SIMD-регистрам
+constexpr int kLanes = 4;
+// Размеры блоков подобраны так, чтобы блок B (kBlockK x kBlockN) помещался в
+// кэш второго уровня
+constexpr int kBlockK = 64;
+constexpr int kBlockN = 256;
+
+/// @brief Умножение строк C на beta. При beta == 0 старые значения C не
+/// читаются (как в BLAS), поэтому NaN в неинициализированном C не мешает
+template <typename T>
+void ScaleRows(std::int64_t m, std::int64_t n, T beta, T* c,
+               std::ptrdiff_t ldc) noexcept {
+  if (beta == T(1)) return;
+  for (std::int64_t i = 0; i < m; ++i) {
+    T* c_row = c + i * ldc;
+    if (beta == T(0)) {
+      std::fill(c_row, c_row + n, T(0));
+    } else {
+      for (std::int64_t j = 0; j < n; ++j) c_row[j] *= beta;
+    }
+  }
+}
+
+/// @brief C = alpha * op(A) * op(B) + beta * C за один проход по C
+/// @param m число строк op(A) и C
+/// @param n число столбцов op(B) и C
+/// @param k число столбцов op(A) и строк op(B)
+/// @param trans_a если true, op(A) = A^T
+/// @param trans_b если true, op(B) = B^T
+template <typename T>
+void GemmImpl(std::int64_t m, std::int64_t n, std::int64_t k, T alpha,
+              const T* a, std::ptrdiff_t lda, bool trans_a, const T* b,
+              std::ptrdiff_t ldb, bool trans_b, T beta, T* c,
+              std::ptrdiff_t ldc) noexcept {
+  ScaleRows(m, n, beta, c, ldc);
+  if (alpha == T(0) || k == 0) return;
+
+  if (!trans_b) {
+    // порядок i-k-j: внутренний цикл идёт по непрерывным строкам B и C
+    for (std::int64_t p0 = 0; p0 < k; p0 += kBlockK) {
+      std::int64_t p1 = std::min<std::int64_t>(p0 + kBlockK, k);
+      for (std::int64_t j0 = 0; j0 < n; j0 += kBlockN) {
+        std::int64_t j1 = std::min<std::int64_t>(j0 + kBlockN, n);
+        for (std::int64_t i = 0; i < m; ++i) {
+          T* c_row = c + i * ldc;
+          for (std::int64_t p = p0; p < p1; ++p) {
+            T a_ip = alpha * (trans_a ? a[p * lda + i] : a[i * lda + p]);
+            const T* b_row = b + p * ldb;
+            for (std::int64_t j = j0; j < j1; ++j) c_row[j] += a_ip * b_row[j];
+          }
+        }
+      }
+    }
+  } else {
+    // op(B) = B^T: элемент C(i, j) - скалярное произведение строк A и B
+    for (std::int64_t i = 0; i < m; ++i) {
+      T* c_row = c + i * ldc;
+      for (std::int64_t j = 0; j < n; ++j) {
+        const T* b_row = b + j * ldb;
+        T sum = 0;
+        for (std::int64_t p = 0; p < k; ++p)
+          sum += (trans_a ? a[p * lda + i] : a[i * lda + p]) * b_row[p];
+        c_row[j] += alpha * sum;
+      }
+    }
+  }
+}
+
+/// @brief Обновление ранга 1: A = A + alpha * x * y^T
+/// @param incx шаг между элементами вектора x
+/// @param incy шаг между элементами вектора y
+template <typename T>
+void GerImpl(std::int64_t m, std::int64_t n, T alpha, const T* x,
+             std::ptrdiff_t incx, const T* y, std::ptrdiff_t incy, T* a,
+             std::ptrdiff_t lda) noexcept {
+  for (std::int64_t i = 0; i < m; ++i) {
+    T x_i = alpha * x[i * incx];
+    T* a_row = a + i * lda;
+    for (std::int64_t j = 0; j < n; ++j) a_row[j] += x_i * y[j * incy];
+  }
+}
+
+/// @brief Сумма term(0) + ... + term(n - 1) по kLanes сумматорам
+template <typename F>
+double LaneSum(std::int64_t n, F term) noexcept {
+  double lanes[kLanes] = {};
+  std::int64_t i = 0;
+  for (; i + kLanes <= n; i += kLanes)
+    for (int l = 0; l < kLanes; ++l) lanes[l] += term(i + l);
+  double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+  for (; i < n; ++i) sum += term(i);
+  return sum;
+}
+
+}  // namespace
+
+void Gemm(std::int64_t m, std::int64_t n, std::int64_t k, double alpha,
+          const double* a, std::ptrdiff_t lda, bool trans_a, const double* b,
+          std::ptrdiff_t ldb, bool trans_b, double beta, double* c,
+          std::ptrdiff_t ldc) noexcept {
+  GemmImpl(m, n, k, alpha, a, lda, trans_a, b, ldb, trans_b, beta, c, ldc);
+}
+
+void Gemm(std::int64_t m, std::int64_t n, std::int64_t k, float alpha,
+          const float* a, std::ptrdiff_t lda, bool trans_a, const float* b,
+          std::ptrdiff_t ldb, bool trans_b, float beta, float* c,
+          std::ptrdiff_t ldc) noexcept {
+  GemmImpl(m, n, k, alpha, a, lda, trans_a, b, ldb, trans_b, beta, c, ldc);
+}
+
+void Ger(std::int64_t m, std::int64_t n, double alpha, const double* x,
+         std::ptrdiff_t incx, const double* y, std::ptrdiff_t incy, double* a,
+         std::ptrdiff_t lda) noexcept {
+  GerImpl(m, n, alpha, x, incx, y, incy, a, lda);
+}
+
+/// @brief y = alpha * op(A) * x + beta * y, A размером m x n
+/// @param trans если true, op(A) = A^T, тогда x длины m, а y длины n
+void Gemv(std::int64_t m, std::int64_t n, double alpha, const double* a,
+          std::ptrdiff_t lda, bool trans, const double* x, double beta,
+          double* y) noexcept {
+  if (!trans) {
+    // y(i) - скалярное произведение непрерывной строки A и x
+    for (std::int64_t i = 0; i < m; ++i) {
+      double dot = alpha == 0 ? 0 : alpha * Dot(n, a + i * lda, x);
+      y[i] = beta == 0 ? dot : beta * y[i] + dot;
+    }
+    return;
+  }
+  // A^T * x - сумма строк A с весами x: внутренний цикл идёт по строке
+  ScaleRows(1, n, beta, y, n);
+  if (alpha == 0) return;
+  for (std::int64_t i = 0; i < m; ++i) Axpy(n, alpha * x[i], a + i * lda, y);
+}
+
+double Dot(std::int64_t n, const double* x, const double* y) noexcept {
+  return LaneSum(n, [x, y](std::int64_t i) { return x[i] * y[i]; });
+}
+
+/// @brief Сумма элементов x
+double Sum(std::int64_t n, const double* x) noexcept {
+  return LaneSum(n, [x](std::int64_t i) { return x[i]; });
+}
+
+/// @brief Сумма модулей элементов x
+double Asum(std::int64_t n, const double* x) noexcept {
+  return LaneSum(n, [x](std::int64_t i) { return std::fabs(x[i]); });
+}
+
+/// @brief y = y + alpha * x
+void Axpy(std::int64_t n, double alpha, const double* x, double* y) noexcept {
+  for (std::int64_t i = 0; i < n; ++i) y[i] += alpha * x[i];
+}
+
+void Ger(std::int64_t m, std::int64_t n, float alpha, const float* x,
+         std::ptrdiff_t incx, const float* y, std::ptrdiff_t incy, float* a,
+         std::ptrdiff_t lda) noexcept {
+  GerImpl(m, n, alpha, x, incx, y, incy, a, lda);
+}
+
+}  // namespace s21_kernels
@@ -0,0 +1,37 @@
+#ifndef S21_KERNELS
+#define S21_KERNELS
+
+#include <cstddef>
+#include <cstdint>
+
+// Низкоуровневые ядра линейной алгебры над непрерывными блоками памяти.
+// Матрицы хранятся построчно, ld* - шаг между соседними строками блока
+namespace s21_kernels {
+
+void Gemm(std::int64_t m, std::int64_t n, std::int64_t k, double alpha,
+          const double* a, std::ptrdiff_t lda, bool trans_a, const double* b,
+          std::ptrdiff_t ldb, bool trans_b, double beta, double* c,
+          std::ptrdiff_t ldc) noexcept;
+void Ger(std::int64_t m, std::int64_t n, double alpha, const double* x,
+         std::ptrdiff_t incx, const double* y, std::ptrdiff_t incy, double* a,
+         std::ptrdiff_t lda) noexcept;
+void Gemv(std::int64_t m, std::int64_t n, double alpha, const double* a,
+          std::ptrdiff_t lda, bool trans, const double* x, double beta,
+          double* y) noexcept;
+double Dot(std::int64_t n, const double* x, const double* y) noexcept;
+double Sum(std::int64_t n, const double* x) noexcept;
+double Asum(std::int64_t n, const double* x) noexcept;
+void Axpy(std::int64_t n, double alpha, const double* x, double* y) noexcept;
+
+// Версии одинарной точности для разложений со смешанной точностью
+void Gemm(std::int64_t m, std::int64_t n, std::int64_t k, float alpha,
+          const float* a, std::ptrdiff_t lda, bool trans_a, const float* b,
+          std::ptrdiff_t ldb, bool trans_b, float beta, float* c,
+          std::ptrdiff_t ldc) noexcept;
+void Ger(std::int64_t m, std::int64_t n, float alpha, const float* x,
+         std::ptrdiff_t incx, const float* y, std::ptrdiff_t incy, float* a,
+         std::ptrdiff_t lda) noexcept;
+
+}  // namespace s21_kernels
+
+#endif  // S21_KERNELS
@@ -0,0 +1,323 @@
+#include "s21_lu.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#include "s21_kernels.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Ширина блока столбцов и размер, начиная с которого разложение идёт в пуле
+constexpr int kBlock = 64;
+constexpr int kParallelThreshold = 256;
+
+// Предел итераций уточнения решения в смешанной точности
+constexpr int kMaxRefinements = 10;
+
+/// @brief Квадратная матрица в построчном буфере, разбитая на блоки столбцов.
+/// T - тип элементов (double или float для смешанной точности)
+template <typename T>
+struct BlockedMatrix {
+  T* a;
+  int n;
+  std::ptrdiff_t lda;
+  int* pivots;
+
+  int Blocks() const { return (n + kBlock - 1) / kBlock; }
+  int Begin(int block) const { return block * kBlock; }
+  int End(int block) const { return std::min(n, (block + 1) * kBlock); }
+  T* At(int i, int j) const { return a + i * lda + j; }
+};
+
+/// @brief Разложение панели (блока столбцов k ниже диагонали) с выбором
+/// ведущего элемента. Перестановки строк применяются только внутри панели
+template <typename T>
+void FactorPanel(const BlockedMatrix<T>& m, int k) {
+  int c0 = m.Begin(k), c1 = m.End(k);
+  for (int c = c0; c < c1; ++c) {
+    int pivot = c;
+    for (int r = c + 1; r < m.n; ++r)
+      if (std::fabs(*m.At(r, c)) > std::fabs(*m.At(pivot, c))) pivot = r;
+    m.pivots[c] = pivot;
+    if (pivot != c) std::swap_ranges(m.At(c, c0), m.At(c, c1), m.At(pivot, c0));
+
+    T diagonal = *m.At(c, c);
+    if (diagonal != T(0)) {
+      for (int r = c + 1; r < m.n; ++r) *m.At(r, c) /= diagonal;
+    }
+    s21_kernels::Ger(m.n - c - 1, c1 - c - 1, T(-1), m.At(c + 1, c), m.lda,
+                     m.At(c, c + 1), 1, m.At(c + 1, c + 1), m.lda);
+  }
+}
+
+/// @brief Обновление блока столбцов j после разложения панели k:
+/// перестановки строк, треугольное решение для блока U и GEMM-обновление
+/// оставшейся части блока
+template <typename T>
+void UpdateBlock(const BlockedMatrix<T>& m, int k, int j) {
+  int c0 = m.Begin(k), c1 = m.End(k), j0 = m.Begin(j), j1 = m.End(j);
+  for (int c = c0; c < c1; ++c) {
+    if (m.pivots[c] != c)
+      std::swap_ranges(m.At(c, j0), m.At(c, j1), m.At(m.pivots[c], j0));
+  }
+  for (int r = c0 + 1; r < c1; ++r) {
+    T* row = m.At(r, j0);
+    for (int c = c0; c < r; ++c) {
+      T l_rc = *m.At(r, c);
+      const T* u_row = m.At(c, j0);
+      for (int col = 0; col < j1 - j0; ++col) row[col] -= l_rc * u_row[col];
+    }
+  }
+  if (c1 < m.n)
+    s21_kernels::Gemm(m.n - c1, j1 - j0, c1 - c0, T(-1), m.At(c1, c0), m.lda,
+                      false, m.At(c0, j0), m.lda, false, T(1), m.At(c1, j0),
+                      m.lda);
+}
+
+/// @brief Планировщик блочного разложения по графу зависимостей.
+/// Обновление (k, j) ждёт панель k и обновление (k - 1, j), панель k + 1
+/// ждёт только обновление (k, k + 1), поэтому следующая панель раскладывается
+/// параллельно с остальными обновлениями текущего шага
+template <typename T>
+class LuScheduler {
+ public:
+  explicit LuScheduler(const BlockedMatrix<T>& m)
+      : m_(m), blocks_(m.Blocks()), dependencies_(blocks_ * blocks_) {
+    for (int k = 0; k < blocks_; ++k)
+      for (int j = k + 1; j < blocks_; ++j)
+        dependencies_[k * blocks_ + j] = k == 0 ? 1 : 2;
+  }
+
+  void Run() {
+    group_.Run([this] { Panel(0); });
+    group_.Wait();
+  }
+
+ private:
+  void Panel(int k) {
+    FactorPanel(m_, k);
+    for (int j = k + 1; j < blocks_; ++j) Release(k, j);
+  }
+
+  void Release(int k, int j) {
+    if (--dependencies_[k * blocks_ + j] == 0)
+      group_.Run([this, k, j] { Update(k, j); });
+  }
+
+  void Update(int k, int j) {
+    UpdateBlock(m_, k, j);
+    if (j == k + 1)
+      Panel(k + 1);
+    else
+      Release(k + 1, j);
+  }
+
+  BlockedMatrix<T> m_;
+  int blocks_;
+  std::vector<std::atomic<int>> dependencies_;
+  S21TaskGroup group_;
+};
+
+/// @brief Блочное LU-разложение на месте. Перестановки строк левее панели
+/// применяются в конце, когда их уже никто не читает
+template <typename T>
+void Factorize(const BlockedMatrix<T>& m) {
+  if (m.n >= kParallelThreshold) {
+    LuScheduler<T>(m).Run();
+  } else {
+    for (int k = 0; k < m.Blocks(); ++k) {
+      FactorPanel(m, k);
+      for (int j = k + 1; j < m.Blocks(); ++j) UpdateBlock(m, k, j);
+    }
+  }
+  for (int k = 1; k < m.Blocks(); ++k) {
+    for (int c = m.Begin(k); c < m.End(k); ++c) {
+      if (m.pivots[c] != c)
+        std::swap_ranges(m.At(c, 0), m.At(c, m.Begin(k)),
+                         m.At(m.pivots[c], 0));
+    }
+  }
+}
+
+/// @brief Прямая и обратная подстановка по готовому LU для столбцов
+/// [from, to) правой части x (решение записывается на её место)
+template <typename T>
+void SolveColumns(const T* lu, std::ptrdiff_t ldlu, int n, const int* pivots,
+                  T* x, std::ptrdiff_t ldx, int from, int to) {
+  for (int i = 0; i < n; ++i) {
+    if (pivots[i] != i)
+      std::swap_ranges(x + i * ldx + from, x + i * ldx + to,
+                       x + pivots[i] * ldx + from);
+  }
+  for (int i = 1; i < n; ++i) {
+    T* row = x + i * ldx;
+    for (int c = 0; c < i; ++c) {
+      T l_ic = lu[i * ldlu + c];
+      const T* solved = x + c * ldx;
+      for (int j = from; j < to; ++j) row[j] -= l_ic * solved[j];
+    }
+  }
+  for (int i = n - 1; i >= 0; --i) {
+    T* row = x + i * ldx;
+    for (int c = i + 1; c < n; ++c) {
+      T u_ic = lu[i * ldlu + c];
+      const T* solved = x + c * ldx;
+      for (int j = from; j < to; ++j) row[j] -= u_ic * solved[j];
+    }
+    T diagonal = lu[i * ldlu + i];
+    for (int j = from; j < to; ++j) row[j] /= diagonal;
+  }
+}
+
+/// @brief Подстановка для всех столбцов, при большом n - в пуле потоков
+template <typename T>
+void SolveAll(const T* lu, std::ptrdiff_t ldlu, int n, const int* pivots, T* x,
+              std::ptrdiff_t ldx, int m) {
+  auto solve_columns = [=](int from, int to) {
+    SolveColumns(lu, ldlu, n, pivots, x, ldx, from, to);
+  };
+  if (n >= kParallelThreshold)
+    S21ThreadPool::Instance().ParallelFor(0, m, solve_columns);
+  else
+    solve_columns(0, m);
+}
+
+}  // namespace
+
+/// @brief Раскладывает квадратную матрицу
+/// @param matrix исходная матрица, не изменяется
+S21LuFactor::S21LuFactor(const S21Matrix& matrix)
+    : lu_(matrix), sign_(1) {
+  if (matrix.GetRows() != matrix.GetCols())
+    throw std::length_error("матрица не является квадратной");
+  lu_.CheckMatrix(lu_);
+  lu_.Detach();
+
+  int n = lu_.GetRows();
+  row_scale_.assign(n, 0);
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+      row_scale_[i] = std::max(row_scale_[i], std::fabs(lu_.Row(i)[j]));
+
+  pivots_.resize(n);
+  Factorize<double>({lu_.matrix_, n, lu_.cols_capacity_, pivots_.data()});
+  for (int i = 0; i < n; ++i) {
+    if (pivots_[i] == i) continue;
+    sign_ = -sign_;
+    std::swap(row_scale_[i], row_scale_[pivots_[i]]);
+  }
+}
+
+int S21LuFactor::GetSize() const noexcept {
+  return static_cast<int>(lu_.rows_);
+}
+
+/// @brief Матрица считается вырожденной, если ведущий элемент пренебрежимо
+/// мал относительно своей строки исходной матрицы. Сравнение по строкам, а
+/// не со всей матрицей, не отвергает невырожденные матрицы с сильно
+/// различающимся масштабом строк
+bool S21LuFactor::IsSingular() const noexcept {
+  double epsilon = GetSize() * std::numeric_limits<double>::epsilon();
+  for (int i = 0; i < GetSize(); ++i)
+    if (std::fabs(lu_.Row(i)[i]) <= epsilon * row_scale_[i]) return true;
+  return false;
+}
+
+/// @brief Определитель как произведение диагонали U с учётом перестановок
+double S21LuFactor::Determinant() const noexcept {
+  double result = sign_;
+  for (int i = 0; i < GetSize(); ++i) result *= lu_.Row(i)[i];
+  return result;
+}
+
+/// @brief Решение системы A * X = B для всех столбцов B сразу. Большие
+/// правые части делятся по столбцам между потоками пула
+/// @param b матрица правых частей размером n x m
+S21Matrix S21LuFactor::Solve(const S21Matrix& b) const {
+  if (b.rows_ != GetSize())
+    throw std::length_error("Разная размерность матриц");
+  if (IsSingular()) throw std::length_error("определитель матрицы равен 0");
+
+  S21Matrix x(b);
+  x.Detach();
+  SolveAll(lu_.matrix_, lu_.cols_capacity_, GetSize(), pivots_.data(),
+           x.matrix_, x.cols_capacity_, x.GetCols());
+  return x;
+}
+
+/// @brief Обратная матрица как решение A * X = E
+S21Matrix S21LuFactor::Inverse() const {
+  S21Matrix identity(GetSize(), GetSize());
+  for (int i = 0; i < GetSize(); ++i) identity(i, i) = 1;
+  return Solve(identity);
+}
+
+/// @brief Решение a * x = b со смешанной точностью: LU-разложение и
+/// подстановки идут в float (вдвое меньше памяти и пропускной способности),
+/// а невязка b - a * x считается в double и уточняет решение, пока оно не
+/// достигнет точности double. Если матрица слишком плохо обусловлена для
+/// float и уточнение не сходится, решение считается целиком в double
+S21Matrix S21LuFactor::SolveMixed(const S21Matrix& a, const S21Matrix& b) {
+  if (a.rows_ != a.cols_)
+    throw std::length_error("матрица не является квадратной");
+  if (b.rows_ != a.rows_) throw std::length_error("Разная размерность матриц");
+  a.CheckMatrix(a);
+  b.CheckMatrix(b);
+
+  int n = a.GetRows(), m = b.GetCols();
+  double max_abs = 0, norm = 0;
+  for (int i = 0; i < n; ++i) {
+    double row_sum = 0;
+    for (int j = 0; j < n; ++j) {
+      max_abs = std::max(max_abs, std::fabs(a.Row(i)[j]));
+      row_sum += std::fabs(a.Row(i)[j]);
+    }
+    norm = std::max(norm, row_sum);
+  }
+  if (norm > std::numeric_limits<float>::max()) return S21LuFactor(a).Solve(b);
+
+  std::vector<float> lu(static_cast<std::size_t>(n) * n);
+  for (std::int64_t i = 0; i < n; ++i)
+    std::copy(a.Row(i), a.Row(i) + n, lu.begin() + i * n);
+  std::vector<int> pivots(n);
+  Factorize<float>({lu.data(), n, n, pivots.data()});
+  float tolerance = n * std::numeric_limits<float>::epsilon() * max_abs;
+  for (std::int64_t i = 0; i < n; ++i)
+    if (std::fabs(lu[i * n + i]) <= tolerance) return S21LuFactor(a).Solve(b);
+
+  // x += a^-1 * rhs, где a^-1 применяется через float-разложение
+  std::vector<float> work(static_cast<std::size_t>(n) * m);
+  S21Matrix x(n, m);
+  auto add_correction = [&](const S21Matrix& rhs) {
+    for (std::int64_t i = 0; i < n; ++i)
+      std::copy(rhs.Row(i), rhs.Row(i) + m, work.begin() + i * m);
+    SolveAll(lu.data(), n, n, pivots.data(), work.data(), m, m);
+    for (std::int64_t i = 0; i < n; ++i)
+      for (int j = 0; j < m; ++j) x.Row(i)[j] += work[i * m + j];
+  };
+
+  add_correction(b);
+  S21Matrix residual;
+  double previous = std::numeric_limits<double>::infinity();
+  double target = std::sqrt(static_cast<double>(n)) *
+                  std::numeric_limits<double>::epsilon() * norm;
+  for (int iteration = 0; iteration < kMaxRefinements; ++iteration) {
+    residual = b;
+    residual.Gemm(-1.0, a, x, 1.0);
+    double residual_norm = 0, x_norm = 0;
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < m; ++j) {
+        residual_norm = std::max(residual_norm, std::fabs(residual.Row(i)[j]));
+        x_norm = std::max(x_norm, std::fabs(x.Row(i)[j]));
+      }
+    }
+    if (residual_norm <= target * x_norm) return x;
+    if (residual_norm > 0.5 * previous) break;
+    previous = residual_norm;
+    add_correction(residual);
+  }
+  return S21LuFactor(a).Solve(b);
+}
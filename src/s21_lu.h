@@ -0,0 +1,31 @@
+#ifndef S21_LU
+#define S21_LU
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+/// @brief LU-разложение с частичным выбором ведущего элемента: P * A = L * U.
+/// Большие матрицы раскладываются блочным алгоритмом, блоки которого
+/// выполняются в пуле потоков по графу зависимостей
+class S21LuFactor {
+ public:
+  explicit S21LuFactor(const S21Matrix& matrix);
+
+  int GetSize() const noexcept;
+  bool IsSingular() const noexcept;
+  double Determinant() const noexcept;
+  S21Matrix Solve(const S21Matrix& b) const;
+  S21Matrix Inverse() const;
+
+  static S21Matrix SolveMixed(const S21Matrix& a, const S21Matrix& b);
+
+ private:
+  S21Matrix lu_;  // L (без единичной диагонали) и U в одной матрице
+  std::vector<int> pivots_;  // Строка, переставленная с i-й на шаге i
+  int sign_;                 // Чётность перестановки
+  // Наибольший модуль в строке исходной матрицы, ставшей i-й строкой U
+  std::vector<double> row_scale_;
+};
+
+#endif  // S21_LU
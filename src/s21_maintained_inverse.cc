@@ -0,0 +1,158 @@
+#include "s21_maintained_inverse.h"
+
+#include <cmath>
+#include <utility>
+
+#include "s21_lu.h"
+
+namespace {
+
+// Если знаменатель обновления меньше этой доли от суммы модулей его
+// слагаемых, при вычислении он почти весь сократился, формула теряет
+// точность и обратная считается заново
+constexpr double kStabilityThreshold = 1e-8;
+
+}  // namespace
+
+/// @brief Раскладывает матрицу и запоминает обратную и определитель
+/// @param period через сколько обновлённых рангов пересчитывать обратную
+S21MaintainedInverse::S21MaintainedInverse(const S21Matrix& matrix,
+                                           int period)
+    : det_(0), period_(period), updates_(0) {
+  if (period <= 0)
+    throw std::length_error("период пересчёта должен быть положительным");
+  Refactorize(matrix);
+}
+
+int S21MaintainedInverse::GetSize() const noexcept {
+  return matrix_.GetRows();
+}
+
+int S21MaintainedInverse::GetPeriod() const noexcept { return period_; }
+
+int S21MaintainedInverse::GetUpdates() const noexcept { return updates_; }
+
+const S21Matrix& S21MaintainedInverse::GetMatrix() const noexcept {
+  return matrix_;
+}
+
+const S21Matrix& S21MaintainedInverse::GetInverse() const noexcept {
+  return inverse_;
+}
+
+double S21MaintainedInverse::Determinant() const noexcept { return det_; }
+
+/// @brief A = A + u * v^T по формуле Шермана-Моррисона:
+/// A^-1 -= (A^-1 u)(v^T A^-1) / (1 + v^T A^-1 u), det *= 1 + v^T A^-1 u
+/// @param u, v столбцы размером n x 1
+void S21MaintainedInverse::RankOneUpdate(const S21Matrix& u,
+                                         const S21Matrix& v) {
+  int n = GetSize();
+  if (u.GetRows() != n || u.GetCols() != 1 || v.GetRows() != n ||
+      v.GetCols() != 1)
+    throw std::length_error("Разная размерность матриц");
+
+  S21Matrix inverse_u(n, 1), inverse_t_v(n, 1);
+  inverse_u.Gemm(1.0, inverse_, u, 0.0);
+  inverse_t_v.Gemm(1.0, inverse_, v, 0.0, true);
+  double denominator = 1.0, scale = 1.0;
+  for (int i = 0; i < n; ++i) {
+    denominator += v(i, 0) * inverse_u(i, 0);
+    scale += std::fabs(v(i, 0) * inverse_u(i, 0));
+  }
+
+  if (std::fabs(denominator) < kStabilityThreshold * scale ||
+      updates_ + 1 >= period_) {
+    S21Matrix updated(matrix_);
+    updated.Ger(1.0, u, v);
+    Refactorize(std::move(updated));
+    return;
+  }
+  matrix_.Ger(1.0, u, v);
+  inverse_.Ger(-1.0 / denominator, inverse_u, inverse_t_v);
+  det_ *= denominator;
+  ++updates_;
+}
+
+/// @brief A = A + U * V^T по формуле Вудбери: при C = I + V^T A^-1 U
+/// A^-1 -= (A^-1 U) C^-1 (V^T A^-1), det *= det(C)
+/// @param u, v матрицы размером n x k
+void S21MaintainedInverse::RankUpdate(const S21Matrix& u, const S21Matrix& v) {
+  int n = GetSize(), k = u.GetCols();
+  if (u.GetRows() != n || v.GetRows() != n || v.GetCols() != k)
+    throw std::length_error("Разная размерность матриц");
+  if (k == 1) {
+    RankOneUpdate(u, v);
+    return;
+  }
+
+  S21Matrix inverse_u(n, k), v_t_inverse(k, n), capacitance(k, k);
+  inverse_u.Gemm(1.0, inverse_, u, 0.0);
+  v_t_inverse.Gemm(1.0, v, inverse_, 0.0, true);
+  capacitance.Gemm(1.0, v, inverse_u, 0.0, true);
+  for (int i = 0; i < k; ++i) capacitance(i, i) += 1.0;
+
+  // Масштаб для det(C): произведение по строкам сумм модулей слагаемых
+  // |V|^T |A^-1 U| и единицы, при k = 1 совпадает с проверкой
+  // Шермана-Моррисона
+  S21Matrix abs_v(v), abs_inverse_u(inverse_u), terms(k, k);
+  abs_v.Apply([](double x) { return std::fabs(x); });
+  abs_inverse_u.Apply([](double x) { return std::fabs(x); });
+  terms.Gemm(1.0, abs_v, abs_inverse_u, 0.0, true);
+  double scale = 1.0;
+  for (int i = 0; i < k; ++i) {
+    double row_sum = 1.0;
+    for (int j = 0; j < k; ++j) row_sum += terms(i, j);
+    scale *= row_sum;
+  }
+
+  S21LuFactor lu(capacitance);
+  double capacitance_det = lu.IsSingular() ? 0 : lu.Determinant();
+  if (std::fabs(capacitance_det) < kStabilityThreshold * scale ||
+      updates_ + k >= period_) {
+    S21Matrix updated(matrix_);
+    updated.Gemm(1.0, u, v, 1.0, false, true);
+    Refactorize(std::move(updated));
+    return;
+  }
+  S21Matrix correction = lu.Solve(v_t_inverse);
+  matrix_.Gemm(1.0, u, v, 1.0, false, true);
+  inverse_.Gemm(-1.0, inverse_u, correction, 1.0);
+  det_ *= capacitance_det;
+  updates_ += k;
+}
+
+/// @brief A(row, col) += delta как обновление ранга 1 единичными векторами
+void S21MaintainedInverse::UpdateEntry(int row, int col, double delta) {
+  int n = GetSize();
+  if (row < 0 || row >= n || col < 0 || col >= n)
+    throw std::length_error("индекс за пределами матрицы");
+  S21Matrix u(n, 1), v(n, 1);
+  u(row, 0) = delta;
+  v(col, 0) = 1.0;
+  RankOneUpdate(u, v);
+}
+
+/// @brief A(row, col) = value
+void S21MaintainedInverse::SetEntry(int row, int col, double value) {
+  int n = GetSize();
+  if (row < 0 || row >= n || col < 0 || col >= n)
+    throw std::length_error("индекс за пределами матрицы");
+  UpdateEntry(row, col, value - matrix_.GetMatrix(row, col));
+}
+
+/// @brief Полный пересчёт обратной и определителя текущей матрицы
+void S21MaintainedInverse::Refactorize() { Refactorize(matrix_); }
+
+/// @brief Пересчёт через LU для новой матрицы. Если она вырождена,
+/// бросается исключение, а состояние объекта не меняется
+void S21MaintainedInverse::Refactorize(S21Matrix matrix) {
+  if (matrix.GetRows() != matrix.GetCols())
+    throw std::length_error("матрица не является квадратной");
+  S21LuFactor lu(matrix);
+  if (lu.IsSingular()) throw std::length_error("определитель матрицы равен 0");
+  inverse_ = lu.Inverse();
+  det_ = lu.Determinant();
+  matrix_ = std::move(matrix);
+  updates_ = 0;
+}
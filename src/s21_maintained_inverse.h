@@ -0,0 +1,38 @@
+#ifndef S21_MAINTAINED_INVERSE
+#define S21_MAINTAINED_INVERSE
+
+#include "s21_matrix_oop.h"
+
+/// @brief Квадратная матрица вместе с обратной и определителем, которые
+/// пересчитываются при малоранговых изменениях за O(n^2 k) по формулам
+/// Шермана-Моррисона-Вудбери и лемме об определителе. Каждые period
+/// обновлённых рангов (и при потере устойчивости) обратная считается
+/// заново через LU, чтобы не накапливалась ошибка округления
+class S21MaintainedInverse {
+ public:
+  explicit S21MaintainedInverse(const S21Matrix& matrix, int period = 64);
+
+  int GetSize() const noexcept;
+  int GetPeriod() const noexcept;
+  int GetUpdates() const noexcept;
+  const S21Matrix& GetMatrix() const noexcept;
+  const S21Matrix& GetInverse() const noexcept;
+  double Determinant() const noexcept;
+
+  void RankOneUpdate(const S21Matrix& u, const S21Matrix& v);
+  void RankUpdate(const S21Matrix& u, const S21Matrix& v);
+  void UpdateEntry(int row, int col, double delta);
+  void SetEntry(int row, int col, double value);
+  void Refactorize();
+
+ private:
+  void Refactorize(S21Matrix matrix);
+
+  S21Matrix matrix_;   // Текущая матрица A
+  S21Matrix inverse_;  // A^-1
+  double det_;         // det(A)
+  int period_;         // Число рангов между полными пересчётами
+  int updates_;        // Рангов обновлено с последнего пересчёта
+};
+
+#endif  // S21_MAINTAINED_INVERSE
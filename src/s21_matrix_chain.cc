@@ -0,0 +1,96 @@
+#include <limits>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+
+/// @brief Произведение цепочки матриц A1 * A2 * ... * An. Порядок умножений
+/// выбирается динамическим программированием по размерностям так, чтобы
+/// число умножений чисел было минимальным. Промежуточные матрицы, которые
+/// больше не нужны, переиспользуются как буферы для следующих произведений
+/// @param chain матрицы в порядке умножения, например {a, b, c}
+S21Matrix S21Matrix::MultiplyChain(
+    const std::vector<std::reference_wrapper<const S21Matrix>>& chain) {
+  int n = static_cast<int>(chain.size());
+  if (n == 0) throw std::length_error("цепочка матриц пустая");
+
+  std::vector<double> dims(n + 1);
+  for (int i = 0; i < n; ++i) {
+    const S21Matrix& matrix = chain[i];
+    matrix.CheckMatrix(matrix);
+    if (i > 0 && static_cast<double>(matrix.rows_) != dims[i])
+      throw std::length_error(
+          "число столбцов первой матрицы не равно числу строк второй матрицы");
+    dims[i] = static_cast<double>(matrix.rows_);
+    dims[i + 1] = static_cast<double>(matrix.cols_);
+  }
+
+  // cost[i][j] - минимальное число умножений для произведения Ai..Aj,
+  // split[i][j] - номер матрицы, после которой ставится внешняя скобка
+  std::vector<std::vector<double>> cost(n, std::vector<double>(n, 0));
+  std::vector<std::vector<int>> split(n, std::vector<int>(n, 0));
+  for (int length = 2; length <= n; ++length) {
+    for (int i = 0; i + length - 1 < n; ++i) {
+      int j = i + length - 1;
+      cost[i][j] = std::numeric_limits<double>::infinity();
+      for (int k = i; k < j; ++k) {
+        double current = cost[i][k] + cost[k + 1][j] +
+                         dims[i] * dims[k + 1] * dims[j + 1];
+        if (current < cost[i][j]) {
+          cost[i][j] = current;
+          split[i][j] = k;
+        }
+      }
+    }
+  }
+
+  struct ChainExecutor {
+    const std::vector<std::reference_wrapper<const S21Matrix>>& chain;
+    const std::vector<std::vector<int>>& split;
+    std::vector<S21Matrix> spare;  // освободившиеся промежуточные матрицы
+
+    /// @brief Матрица нужного размера: по возможности освободившийся буфер
+    /// достаточной ёмкости, его старые значения перезапишет Gemm
+    S21Matrix Acquire(std::int64_t rows, std::int64_t cols) {
+      for (auto it = spare.begin(); it != spare.end(); ++it) {
+        if (it->rows_capacity_ >= rows && it->cols_capacity_ >= cols) {
+          S21Matrix result(std::move(*it));
+          spare.erase(it);
+          result.rows_ = rows;
+          result.cols_ = cols;
+          return result;
+        }
+      }
+      return S21Matrix(rows, cols);
+    }
+
+    /// @brief Произведение Ai..Aj. Одиночная матрица берётся из цепочки без
+    /// копирования, иначе результат сохраняется в holder
+    const S21Matrix& Operand(int i, int j, S21Matrix* holder) {
+      if (i == j) return chain[i];
+      *holder = Product(i, j);
+      return *holder;
+    }
+
+    S21Matrix Product(int i, int j) {
+      int k = split[i][j];
+      S21Matrix left_holder, right_holder;
+      const S21Matrix& left = Operand(i, k, &left_holder);
+      const S21Matrix& right = Operand(k + 1, j, &right_holder);
+
+      S21Matrix result = Acquire(left.rows_, right.cols_);
+      s21_kernels::Gemm(left.rows_, right.cols_, left.cols_, 1.0, left.matrix_,
+                        left.cols_capacity_, false, right.matrix_,
+                        right.cols_capacity_, false, 0.0, result.matrix_,
+                        result.cols_capacity_);
+      if (left_holder.matrix_ != nullptr)
+        spare.push_back(std::move(left_holder));
+      if (right_holder.matrix_ != nullptr)
+        spare.push_back(std::move(right_holder));
+      return result;
+    }
+  };
+
+  if (n == 1) return chain[0];
+  ChainExecutor executor{chain, split, {}};
+  return executor.Product(0, n - 1);
+}
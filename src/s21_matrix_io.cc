@@ -0,0 +1,209 @@
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Размер буфера записи и запас под одно число с разделителем
+constexpr std::size_t kWriteBuffer = 1 << 20;
+constexpr std::size_t kMaxNumberChars = 32;
+// Начиная с этого размера текст разбирается в пуле потоков
+constexpr std::size_t kParallelParseBytes = 1 << 20;
+
+/// @brief Выводит элементы матрицы через буфер кусками: числа форматирует
+/// std::to_chars в кратчайшем представлении, которое читается обратно без
+/// потерь, а готовые куски отдаются в sink(data, size)
+template <typename Sink>
+void WriteBuffered(const double* data, std::int64_t stride, std::int64_t rows,
+                   std::int64_t cols, char delimiter, Sink sink) {
+  std::vector<char> buffer(kWriteBuffer);
+  char* begin = buffer.data();
+  char* end = begin + buffer.size();
+  char* position = begin;
+  // Сбрасывает буфер, если в нём меньше bytes свободных байт
+  auto reserve = [&](std::size_t bytes) {
+    if (static_cast<std::size_t>(end - position) < bytes) {
+      sink(begin, position - begin);
+      position = begin;
+    }
+  };
+  for (std::int64_t i = 0; i < rows; ++i) {
+    for (std::int64_t j = 0; j < cols; ++j) {
+      reserve(kMaxNumberChars);
+      if (j > 0) *position++ = delimiter;
+      position = std::to_chars(position, end, data[i * stride + j]).ptr;
+    }
+    reserve(1);
+    *position++ = '\n';
+  }
+  if (position != begin) sink(begin, position - begin);
+}
+
+bool IsSeparator(char c) {
+  return c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r';
+}
+
+/// @brief Результат разбора куска текста: значения подряд по строкам
+struct ParsedChunk {
+  std::vector<double> values;
+  std::int64_t rows = 0;
+  std::int64_t cols = -1;
+};
+
+/// @brief Разбирает строки текста [begin, end): числа разделены пробелами,
+/// табуляцией, запятыми или точкой с запятой, строки - переводом строки,
+/// пустые строки пропускаются
+void ParseChunk(const char* begin, const char* end, ParsedChunk* chunk) {
+  const char* position = begin;
+  while (position < end) {
+    std::int64_t count = 0;
+    while (position < end && *position != '\n') {
+      if (IsSeparator(*position)) {
+        ++position;
+        continue;
+      }
+      if (*position == '+') ++position;
+      double value = 0;
+      auto [next, error] = std::from_chars(position, end, value);
+      if (error != std::errc() ||
+          (next < end && !IsSeparator(*next) && *next != '\n'))
+        throw std::invalid_argument("некорректное число в тексте матрицы");
+      chunk->values.push_back(value);
+      ++count;
+      position = next;
+    }
+    ++position;
+    if (count == 0) continue;
+    if (chunk->cols != -1 && chunk->cols != count)
+      throw std::length_error("Разное число элементов в строках матрицы");
+    chunk->cols = count;
+    ++chunk->rows;
+  }
+}
+
+}  // namespace
+
+/// @brief Процедура печати матрицы
+void S21Matrix::PrintMatrix() const noexcept {
+  try {
+    WriteText(std::cout);
+  } catch (...) {
+  }
+}
+
+/// @brief Запись матрицы текстом в поток: строка матрицы на строку текста,
+/// числа в кратчайшем представлении, которое читается обратно без потерь
+/// @param delimiter разделитель элементов строки
+void S21Matrix::WriteText(std::ostream& out, char delimiter) const {
+  WriteBuffered(matrix_, cols_capacity_, rows_, cols_, delimiter,
+                [&out](const char* data, std::size_t size) {
+                  out.write(data, size);
+                });
+  if (!out) throw std::runtime_error("ошибка записи матрицы в поток");
+}
+
+/// @brief Запись матрицы текстом в файловый дескриптор (см. WriteText)
+void S21Matrix::WriteText(int fd, char delimiter) const {
+  WriteBuffered(matrix_, cols_capacity_, rows_, cols_, delimiter,
+                [fd](const char* data, std::size_t size) {
+                  while (size > 0) {
+                    ssize_t written = ::write(fd, data, size);
+                    if (written < 0) {
+                      if (errno == EINTR) continue;
+                      throw std::system_error(errno, std::generic_category(),
+                                              "ошибка записи матрицы");
+                    }
+                    data += written;
+                    size -= written;
+                  }
+                });
+}
+
+/// @brief Разбор матрицы из текста: строка текста - строка матрицы, числа
+/// разделены пробелами, табуляцией, запятыми или точкой с запятой (CSV).
+/// Большой текст делится по переводам строк на куски, которые разбираются
+/// параллельно
+S21Matrix S21Matrix::ParseText(std::string_view text) {
+  int chunks = 1;
+  if (text.size() >= kParallelParseBytes)
+    chunks = S21ThreadPool::Instance().Size() + 1;
+
+  std::vector<const char*> bounds(chunks + 1);
+  bounds[0] = text.data();
+  bounds[chunks] = text.data() + text.size();
+  for (int c = 1; c < chunks; ++c) {
+    std::size_t offset = std::max<std::size_t>(
+        text.size() * c / chunks, bounds[c - 1] - text.data());
+    std::size_t newline = text.find('\n', offset);
+    bounds[c] = newline == std::string_view::npos ? bounds[chunks]
+                                                  : text.data() + newline + 1;
+  }
+
+  std::vector<ParsedChunk> parsed(chunks);
+  std::vector<std::exception_ptr> errors(chunks);
+  auto parse = [&](int from, int to) {
+    for (int c = from; c < to; ++c) {
+      try {
+        ParseChunk(bounds[c], bounds[c + 1], &parsed[c]);
+      } catch (...) {
+        errors[c] = std::current_exception();
+      }
+    }
+  };
+  if (chunks > 1)
+    S21ThreadPool::Instance().ParallelFor(0, chunks, parse);
+  else
+    parse(0, 1);
+  for (const auto& error : errors)
+    if (error) std::rethrow_exception(error);
+
+  std::int64_t rows = 0, cols = -1;
+  for (const auto& chunk : parsed) {
+    if (chunk.rows == 0) continue;
+    if (cols != -1 && cols != chunk.cols)
+      throw std::length_error("Разное число элементов в строках матрицы");
+    cols = chunk.cols;
+    rows += chunk.rows;
+  }
+  if (rows == 0) return S21Matrix();
+
+  S21Matrix result(rows, cols);
+  std::int64_t row = 0;
+  for (const auto& chunk : parsed) {
+    for (std::int64_t i = 0; i < chunk.rows; ++i, ++row)
+      std::copy(chunk.values.begin() + i * cols,
+                chunk.values.begin() + (i + 1) * cols, result.Row(row));
+  }
+  return result;
+}
+
+/// @brief Чтение матрицы из потока до его конца (см. ParseText)
+S21Matrix S21Matrix::ReadText(std::istream& in) {
+  std::string text((std::istreambuf_iterator<char>(in)),
+                   std::istreambuf_iterator<char>());
+  return ParseText(text);
+}
+
+/// @brief Чтение матрицы из файла (см. ParseText)
+S21Matrix S21Matrix::ReadTextFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) throw std::runtime_error("не удалось открыть файл " + path);
+  std::string text(static_cast<std::size_t>(file.tellg()), '\0');
+  file.seekg(0);
+  file.read(text.data(), text.size());
+  if (!file) throw std::runtime_error("ошибка чтения файла " + path);
+  return ParseText(text);
+}
@@ -2,15 +2,128 @@
 
 #include <math.h>
 
-#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+
+#include "s21_kernels.h"
+#include "s21_lu.h"
+#include "s21_qr.h"
+#include "s21_thread_pool.h"
+
+/// @brief Производные результаты матрицы, посчитанные с последнего изменения
+struct S21DerivedCache {
+  std::optional<std::shared_ptr<const S21LuFactor>> lu;
+  std::optional<double> determinant;
+  std::optional<S21Matrix> inverse;
+  std::optional<S21Matrix> transpose;
+
+  template <typename T>
+  static T Share(const T& value) {
+    return value;
+  }
+  static S21Matrix Share(S21Matrix& value);
+};
+
+/// @brief Копия матрицы для кеша или из кеша, разделяющая с ней буфер без
+/// копирования элементов. Буфер становится разделяемым независимо от
+/// SetCopyOnWrite; изменение любой из копий отделяет её (Detach).
+/// Маленькие матрицы во встроенном буфере и внешние буферы копируются
+S21Matrix S21DerivedCache::Share(S21Matrix& value) {
+  if (value.refs_ == nullptr && value.matrix_ != nullptr &&
+      !value.IsInline() && value.external_ == nullptr)
+    value.refs_ = new std::atomic<int>(1);
+  if (value.refs_ == nullptr) return value;
+  S21Matrix shared;
+  shared.ShareMem(value);
+  return shared;
+}
+
+namespace {
+
+// Включено ли копирование при записи для новых буферов и копий
+std::atomic<bool> copy_on_write(false);
+
+// Начиная с этого числа элементов операции делятся по строкам между
+// потоками пула
+std::atomic<long long> parallel_threshold(1 << 16);
+// Сторона квадратного блока при транспонировании
+constexpr int kTransposeBlock = 32;
+
+// Кеш производных результатов. Мьютексы защищают только поиск и запись в
+// кеш, сами вычисления идут без блокировки. Мьютекс выбирается по адресу
+// матрицы, поэтому независимые матрицы почти не ждут друг друга
+std::atomic<bool> caching(false);
+constexpr std::size_t kCacheLocks = 64;
+std::mutex cache_mutexes[kCacheLocks];
+std::atomic<std::size_t> cache_hits(0);
+std::atomic<std::size_t> cache_misses(0);
+std::atomic<std::size_t> cache_invalidations(0);
+
+/// @brief Мьютекс кеша матрицы, которой принадлежит cache
+std::mutex &CacheMutex(const std::unique_ptr<S21DerivedCache> *cache) {
+  std::uintptr_t address = reinterpret_cast<std::uintptr_t>(cache);
+  return cache_mutexes[(address >> 4 ^ address >> 10) % kCacheLocks];
+}
+
+/// @brief Возвращает результат из кеша или вычисляет и запоминает его.
+/// Матрицы из кеша разделяют с ним буфер, поэтому попадание в кеш не
+/// копирует элементы. При выключенном кеше просто вычисляет
+template <typename T, typename Compute>
+T Memoize(std::unique_ptr<S21DerivedCache> *cache,
+          std::optional<T> S21DerivedCache::*slot, Compute compute) {
+  if (!caching) return compute();
+  std::mutex &mutex = CacheMutex(cache);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (*cache && (**cache).*slot) {
+      ++cache_hits;
+      return S21DerivedCache::Share(*((**cache).*slot));
+    }
+  }
+  ++cache_misses;
+  T value = compute();
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!*cache) *cache = std::make_unique<S21DerivedCache>();
+  (**cache).*slot = S21DerivedCache::Share(value);
+  return value;
+}
+
+/// @brief Транспонирование на месте плотной построчной матрицы rows x cols
+/// обходом циклов перестановки элементов
+/// @param moved отметки переставленных элементов, по биту на элемент.
+/// Выделяются вызывающим заранее, чтобы сама перестановка не бросала
+void TransposeInPlace(double *data, std::int64_t rows, std::int64_t cols,
+                      std::vector<bool> *moved) noexcept {
+  std::size_t size = static_cast<std::size_t>(rows) * cols;
+  if (rows <= 1 || cols <= 1) return;
+  for (std::size_t start = 1; start + 1 < size; ++start) {
+    if ((*moved)[start]) continue;
+    std::size_t position = start;
+    double value = data[start];
+    do {
+      // Элемент (i, j) переходит на место (j, i) матрицы cols x rows
+      position = (position % cols) * rows + position / cols;
+      std::swap(value, data[position]);
+      (*moved)[position] = true;
+    } while (position != start);
+  }
+}
+
+}  // namespace
 
 /// @brief Стандарный конструктор (создаёт нулевую матрицу)
-S21Matrix::S21Matrix() noexcept { CreateNullMatrix(); }
+S21Matrix::S21Matrix() noexcept : policy_(S21Allocator::GetDefaultPolicy()) {
+  CreateNullMatrix();
+}
 
 /// @brief Конструктор с параметрами размера матрицы
 /// @param rows Входящее число строк
 /// @param cols Входящее число колонок
-S21Matrix::S21Matrix(int rows, int cols) : rows_(rows), cols_(cols) {
+S21Matrix::S21Matrix(std::int64_t rows, std::int64_t cols)
+    : rows_(rows), cols_(cols), policy_(S21Allocator::GetDefaultPolicy()) {
   if (rows < 0 || cols < 0)
     CreateNullMatrix();
   else {
@@ -21,19 +134,36 @@ S21Matrix::S21Matrix(int rows, int cols) : rows_(rows), cols_(cols) {
 /// @brief Конструктор копирования - создаёт новый объект через конструктор с
 /// параметрами и копирует значения атрибутов из объекта other
 /// @param other объект, из которого копируются атрибуты
-S21Matrix::S21Matrix(const S21Matrix &other) {
-  AlocateMem(other.rows_, other.cols_);
-  CopyMatrixData(other);
+S21Matrix::S21Matrix(const S21Matrix &other) : policy_(other.policy_) {
+  if (other.refs_ != nullptr && copy_on_write) {
+    ShareMem(other);
+  } else {
+    AlocateMem(other.rows_, other.cols_);
+    CopyMatrixData(other);
+  }
 }
 
 /// @brief Конструктор перемещения - копирует данные в новый объект и удаляет в
 /// старом. Через swap меняются местами указатели у атрибутов
 /// @param other объект, из которого перемещаются атрибуты
 S21Matrix::S21Matrix(S21Matrix &&other) noexcept
-    : rows_(0), cols_(0), matrix_(nullptr) {
+    : rows_(0),
+      cols_(0),
+      rows_capacity_(0),
+      cols_capacity_(0),
+      matrix_(nullptr),
+      policy_(other.policy_),
+      refs_(nullptr),
+      external_(nullptr),
+      cache_(std::move(other.cache_)) {
   std::swap(other.cols_, cols_);
   std::swap(other.rows_, rows_);
+  std::swap(other.cols_capacity_, cols_capacity_);
+  std::swap(other.rows_capacity_, rows_capacity_);
   std::swap(other.matrix_, matrix_);
+  std::swap(other.refs_, refs_);
+  std::swap(other.external_, external_);
+  AdoptInline(&other);
 }
 
 /// @brief Деструктор - очищает двумерный массив matrix_ и обнуляет
@@ -47,87 +177,407 @@ S21Matrix::~S21Matrix() {
 // геттеры и сеттеры
 /* В SetRows и SetCols реализуется алгоритм: если число строк/столбцов
 увеличивается, в качестве новых элементов ставятся нули, если уменьшается, то
-матрица урезается */
+матрица урезается. Пока хватает зарезервированной памяти, перевыделения не
+происходит, а при её нехватке ёмкость растёт геометрически (как у std::vector),
+поэтому построчное наращивание матрицы работает за амортизированное O(1) на
+строку */
 
-void S21Matrix::SetRows(int numb) {
+void S21Matrix::SetRows(std::int64_t numb) {
+  S21MemoryScope scope("SetRows");
   if (numb < 0)
     throw std::length_error("число строк не может быть отрицательным");
 
-  if (rows_ != numb) {
-    S21Matrix temp = S21Matrix(numb, cols_);
-    for (int i = 0; i < temp.rows_; ++i) {
-      for (int j = 0; j < temp.cols_; ++j) {
-        if (i < rows_) temp(i, j) = matrix_[i][j];
-      }
-    }
-    DeleteMem();
-    AlocateMem(temp.rows_, temp.cols_);
-    CopyMatrixData(temp);
+  Invalidate();
+  // Запас внешнего буфера может принадлежать чужим данным
+  if (numb > rows_capacity_ || (numb > rows_ && external_ != nullptr)) {
+    Reallocate(std::max(numb, 2 * rows_capacity_), cols_capacity_);
+  } else if (numb > rows_) {
+    Detach();
+    for (std::int64_t i = rows_; i < numb; ++i)
+      std::fill(Row(i), Row(i) + cols_, 0.0);
   }
+  rows_ = numb;
 }
 
-void S21Matrix::SetCols(int numb) {
+void S21Matrix::SetCols(std::int64_t numb) {
+  S21MemoryScope scope("SetCols");
   if (numb < 0)
     throw std::length_error("число столбцов не может быть отрицательным");
 
-  if (cols_ != numb) {
-    S21Matrix temp = S21Matrix(rows_, numb);
-    for (int i = 0; i < temp.rows_; ++i) {
-      for (int j = 0; j < temp.cols_; ++j) {
-        if (j < cols_) temp(i, j) = matrix_[i][j];
-      }
-    }
-    DeleteMem();
-    AlocateMem(temp.rows_, temp.cols_);
-    CopyMatrixData(temp);
+  Invalidate();
+  if (numb > cols_capacity_ || (numb > cols_ && external_ != nullptr)) {
+    Reallocate(rows_capacity_, std::max(numb, 2 * cols_capacity_));
+  } else if (numb > cols_) {
+    Detach();
+    for (std::int64_t i = 0; i < rows_; ++i)
+      std::fill(Row(i) + cols_, Row(i) + numb, 0.0);
   }
+  cols_ = numb;
 }
+
+/// @brief Резервирует память под матрицу размером не меньше rows x cols без
+/// изменения её размерности
+/// @param rows число строк, под которое резервируется память
+/// @param cols число столбцов, под которое резервируется память
+void S21Matrix::Reserve(std::int64_t rows, std::int64_t cols) {
+  if (rows < 0 || cols < 0)
+    throw std::length_error(
+        "число столбцов и строк не может быть отрицательным");
+  if (rows > rows_capacity_ || cols > cols_capacity_)
+    Reallocate(std::max(rows, rows_capacity_), std::max(cols, cols_capacity_));
+}
+
+/// @brief Освобождает зарезервированную, но не используемую память
+void S21Matrix::ShrinkToFit() {
+  if (rows_capacity_ != rows_ || cols_capacity_ != cols_)
+    Reallocate(rows_, cols_);
+}
+
+/// @brief Меняет политику выделения памяти. Если буфер уже выделен, он
+/// перевыделяется по новой политике
+void S21Matrix::SetAllocPolicy(const S21AllocPolicy &policy) {
+  S21Matrix temp;
+  temp.policy_ = policy;
+  if (matrix_ != nullptr) {
+    temp.AlocateMem(rows_, cols_);
+    temp.CopyMatrixData(*this);
+  }
+  *this = std::move(temp);
+}
+
+S21AllocPolicy S21Matrix::GetAllocPolicy() const { return policy_; }
+
+/// @brief Порог распараллеливания. Строки делятся между потоками статически
+/// и одинаково для обнуления нового буфера и последующих операций, так что
+/// поток работает со страницами, которые сам разместил. Результаты не
+/// зависят ни от порога, ни от числа потоков
+void S21Matrix::SetParallelThreshold(long long elements) {
+  if (elements < 1)
+    throw std::length_error(
+        "порог распараллеливания должен быть положительным");
+  parallel_threshold = elements;
+  S21Allocator::SetParallelTouchBytes(elements * sizeof(double));
+}
+
+long long S21Matrix::GetParallelThreshold() { return parallel_threshold; }
+
+/// @brief Матрица становится владельцем внешнего буфера без копирования и
+/// освобождает его вызовом deleter. Буфер по столбцам (kColMajor) должен
+/// быть плотным и переставляется в построчный порядок на месте; из
+/// дополнительной памяти нужен только бит на элемент. При исключении буфер
+/// остаётся у вызывающего нетронутым
+/// @param stride шаг между строками в элементах, 0 - плотный буфер
+S21Matrix S21Matrix::Adopt(double *data, std::int64_t rows, std::int64_t cols,
+                           S21Deleter deleter, S21Layout layout,
+                           std::int64_t stride) {
+  if (layout == S21Layout::kRowMajor)
+    return External(data, rows, cols, stride, std::move(deleter));
+  if (stride != 0 && stride != rows)
+    throw std::length_error("буфер по столбцам должен быть плотным");
+  // Проверки и выделения памяти идут до перестановки, которая уже не бросает
+  std::vector<bool> moved;
+  if (rows > 1 && cols > 1) moved.resize(static_cast<std::size_t>(rows) * cols);
+  S21Matrix result = External(data, rows, cols, 0, std::move(deleter));
+  TransposeInPlace(data, cols, rows, &moved);
+  return result;
+}
+
+/// @brief Матрица поверх чужого буфера без копирования: изменения пишутся
+/// в буфер, который должен жить дольше матрицы и её копий. Рост размеров
+/// (SetRows, SetCols) переносит матрицу в собственную память. Буфер только
+/// построчный: перестановка на месте испортила бы чужие данные для владельца
+/// @param stride шаг между строками в элементах, 0 - плотный буфер
+S21Matrix S21Matrix::Borrow(double *data, std::int64_t rows, std::int64_t cols,
+                            std::int64_t stride) {
+  return External(data, rows, cols, stride, S21Deleter());
+}
+
+S21Matrix S21Matrix::External(double *data, std::int64_t rows,
+                              std::int64_t cols, std::int64_t stride,
+                              S21Deleter deleter) {
+  if (rows < 0 || cols < 0 || stride < 0)
+    throw std::length_error(
+        "число столбцов и строк не может быть отрицательным");
+  if (stride == 0) stride = cols;
+  if (stride < cols)
+    throw std::length_error("шаг строк меньше числа столбцов");
+  if (data == nullptr && rows > 0 && cols > 0)
+    throw std::invalid_argument("внешний буфер не задан");
+
+  auto external = std::make_unique<S21Deleter>(std::move(deleter));
+  S21Matrix result;
+  result.refs_ =
+      copy_on_write && data != nullptr ? new std::atomic<int>(1) : nullptr;
+  result.rows_ = rows;
+  result.cols_ = cols;
+  result.rows_capacity_ = rows;
+  result.cols_capacity_ = stride;
+  result.matrix_ = data;
+  result.external_ = external.release();
+  return result;
+}
+
+/// @brief Отдаёт буфер матрицы новому владельцу без копирования, после
+/// чего матрица становится пустой. Разделяемый буфер сначала копируется
+S21Buffer S21Matrix::Release() {
+  Detach();
+  if (IsInline()) {
+    double *heap =
+        S21Allocator::Allocate(rows_capacity_, cols_capacity_, policy_);
+    std::copy(inline_, inline_ + rows_capacity_ * cols_capacity_, heap);
+    matrix_ = heap;
+  }
+  S21Buffer buffer;
+  buffer.data = matrix_;
+  buffer.rows = rows_;
+  buffer.cols = cols_;
+  buffer.stride = cols_capacity_;
+  if (external_ != nullptr) {
+    buffer.deleter = std::move(*external_);
+  } else if (matrix_ != nullptr) {
+    std::int64_t rows = rows_capacity_, cols = cols_capacity_;
+    S21AllocPolicy policy = policy_;
+    buffer.deleter = [rows, cols, policy](double *data) {
+      S21Allocator::Free(data, rows, cols, policy);
+    };
+  }
+  delete external_;
+  delete refs_;
+  CreateNullMatrix();
+  return buffer;
+}
+
+/// @brief Лежит ли матрица во внешнем буфере (Adopt, Borrow)
+bool S21Matrix::IsExternal() const { return external_ != nullptr; }
+
+/// @brief Включает копирование при записи. Копии матриц, выделенных при
+/// включённом режиме, разделяют буфер за O(1), а собственный буфер копия
+/// получает при первом изменении. Ссылка, полученная через неконстантный
+/// operator(), действительна только до копирования матрицы
+void S21Matrix::SetCopyOnWrite(bool enabled) { copy_on_write = enabled; }
+
+bool S21Matrix::GetCopyOnWrite() { return copy_on_write; }
+
+/// @brief Разделяет ли матрица буфер с другими матрицами
+bool S21Matrix::IsShared() const { return refs_ != nullptr && *refs_ > 1; }
+
+/// @brief Включает кеширование производных результатов: LU-разложение,
+/// определитель, обратная и транспонированная матрицы запоминаются до
+/// первого изменения матрицы. Изменением считается любой неконстантный
+/// доступ к элементам, в том числе чтение через неконстантный operator()
+void S21Matrix::SetCaching(bool enabled) { caching = enabled; }
+
+bool S21Matrix::GetCaching() { return caching; }
+
+S21CacheStats S21Matrix::GetCacheStats() {
+  S21CacheStats stats;
+  stats.hits = cache_hits;
+  stats.misses = cache_misses;
+  stats.invalidations = cache_invalidations;
+  return stats;
+}
+
+void S21Matrix::ResetCacheStats() {
+  cache_hits = 0;
+  cache_misses = 0;
+  cache_invalidations = 0;
+}
+
+std::int64_t S21Matrix::GetRowsCapacity() const { return rows_capacity_; }
+std::int64_t S21Matrix::GetColsCapacity() const { return cols_capacity_; }
+
+/// @brief Добавляет строку в конец матрицы. У пустой матрицы число столбцов
+/// берётся из добавляемой строки
+/// @param row матрица размером 1 x cols
+void S21Matrix::AppendRow(const S21Matrix &row) {
+  if (rows_ == 0 && cols_ == 0) SetCols(row.cols_);
+  if (row.rows_ != 1 || row.cols_ != cols_)
+    throw std::length_error("размер строки не совпадает с числом столбцов");
+
+  SetRows(rows_ + 1);
+  std::copy(row.Row(0), row.Row(0) + cols_, Row(rows_ - 1));
+}
+
+/// @brief Удаляет строку, сдвигая последующие строки вверх. Память не
+/// перевыделяется
+/// @param row номер удаляемой строки
+void S21Matrix::RemoveRow(std::int64_t row) {
+  if (row < 0 || row >= rows_)
+    throw std::length_error("индекс за пределами матрицы");
+
+  Detach();
+  for (std::int64_t i = row + 1; i < rows_; ++i)
+    std::copy(Row(i), Row(i) + cols_, Row(i - 1));
+  --rows_;
+}
+
 /// @brief Метод изменяет значение конкретного элемента матрицы
 /// @param numb значение
 /// @param row номер строки
 /// @param col номер столбца
-void S21Matrix::SetMatrix(int numb, int row, int col) {
+void S21Matrix::SetMatrix(int numb, std::int64_t row, std::int64_t col) {
   if (row < 0 || col < 0)
     throw std::length_error(
         "число столбцов и строк не может быть отрицательным");
-  matrix_[row][col] = numb;
+  Detach();
+  Row(row)[col] = numb;
+}
+int S21Matrix::GetRows() const {
+  if (rows_ > std::numeric_limits<int>::max())
+    throw std::length_error("число строк не помещается в int");
+  return static_cast<int>(rows_);
+}
+int S21Matrix::GetCols() const {
+  if (cols_ > std::numeric_limits<int>::max())
+    throw std::length_error("число столбцов не помещается в int");
+  return static_cast<int>(cols_);
 }
-int S21Matrix::GetRows() const { return rows_; }
-int S21Matrix::GetCols() const { return cols_; }
-double S21Matrix::GetMatrix(int row, int col) const {
-  return matrix_[row][col];
+std::int64_t S21Matrix::GetRows64() const noexcept { return rows_; }
+std::int64_t S21Matrix::GetCols64() const noexcept { return cols_; }
+double S21Matrix::GetMatrix(std::int64_t row, std::int64_t col) const {
+  return Row(row)[col];
 }
 
 /// @brief Создание пустой матрицы
 void S21Matrix::CreateNullMatrix() noexcept {
   rows_ = 0;
   cols_ = 0;
+  rows_capacity_ = 0;
+  cols_capacity_ = 0;
   matrix_ = nullptr;
+  refs_ = nullptr;
+  external_ = nullptr;
 }
 
 /// @brief Функция выделения памяти для массива матрицы и заполнения её нулями
 /// через()
 /// @param other_rows число строк
 /// @param other_cols число столбцов
-void S21Matrix::AlocateMem(int other_rows, int other_cols) noexcept {
+void S21Matrix::AlocateMem(std::int64_t other_rows, std::int64_t other_cols) {
   rows_ = other_rows;
   cols_ = other_cols;
-  matrix_ = new double *[rows_];
+  rows_capacity_ = other_rows;
+  cols_capacity_ = other_cols;
+  matrix_ = Acquire(rows_capacity_, cols_capacity_);
+  refs_ = copy_on_write && matrix_ != nullptr && !IsInline()
+              ? new std::atomic<int>(1)
+              : nullptr;
+  external_ = nullptr;
+}
+
+/// @brief Буфер под ёмкость rows x cols, заполненный нулями. Маленькие
+/// матрицы получают буфер внутри объекта без обращения к аллокатору
+double *S21Matrix::Acquire(std::int64_t rows_capacity,
+                           std::int64_t cols_capacity) {
+  // Сначала сравниваются сами размеры: произведение огромных размеров
+  // переполнилось бы до проверки в аллокаторе
+  if (rows_capacity > kInlineElements || cols_capacity > kInlineElements)
+    return S21Allocator::Allocate(rows_capacity, cols_capacity, policy_);
+  std::int64_t size = rows_capacity * cols_capacity;
+  if (size == 0 || size > kInlineElements)
+    return S21Allocator::Allocate(rows_capacity, cols_capacity, policy_);
+  std::fill(inline_, inline_ + size, 0.0);
+  return inline_;
+}
 
-  for (int i = 0; i < rows_; ++i) {
-    matrix_[i] = new double[cols_]();
+/// @brief После перемещения из other: буфер, оставшийся внутри other,
+/// копируется в свой, так как указатель на чужой объект переносить нельзя
+void S21Matrix::AdoptInline(S21Matrix *other) noexcept {
+  if (matrix_ != other->inline_) return;
+  std::copy(other->inline_, other->inline_ + rows_capacity_ * cols_capacity_,
+            inline_);
+  matrix_ = inline_;
+}
+
+/// @brief Перевыделяет буфер под новую ёмкость, сохраняя элементы матрицы.
+/// Новые элементы заполняются нулями
+/// @param rows_capacity новое число зарезервированных строк
+/// @param cols_capacity новое число зарезервированных столбцов
+void S21Matrix::Reallocate(std::int64_t rows_capacity,
+                           std::int64_t cols_capacity) {
+  // Старый буфер внутри объекта сохраняется: новый может занять его место
+  double saved[kInlineElements];
+  const double *source = matrix_;
+  if (IsInline()) {
+    std::copy(inline_, inline_ + rows_capacity_ * cols_capacity_, saved);
+    source = saved;
   }
+  std::int64_t stride = cols_capacity_;
+  double *buffer = Acquire(rows_capacity, cols_capacity);
+  std::int64_t rows = std::min(rows_, rows_capacity);
+  std::int64_t cols = std::min(cols_, cols_capacity);
+  for (std::int64_t i = 0; i < rows; ++i)
+    std::copy(source + i * stride, source + i * stride + cols,
+              buffer + i * cols_capacity);
+
+  DeleteMem();
+  matrix_ = buffer;
+  refs_ = copy_on_write && matrix_ != nullptr && !IsInline()
+              ? new std::atomic<int>(1)
+              : nullptr;
+  rows_ = rows;
+  cols_ = cols;
+  rows_capacity_ = rows_capacity;
+  cols_capacity_ = cols_capacity;
 }
 
-/// @brief Очистка памяти матрицы и установка значений указателей nullptr
+/// @brief Очистка памяти матрицы и установка значений указателей nullptr.
+/// Разделяемый буфер освобождает последний владелец
 void S21Matrix::DeleteMem() noexcept {
-  if (matrix_ != nullptr) {
-    for (int i = 0; i < rows_; ++i) {
-      if (matrix_[i] != nullptr) delete[] matrix_[i];
-    }
-    delete[] matrix_;
-    matrix_ = nullptr;
+  Invalidate();
+  // Буфер внутри объекта не разделяется и не освобождается
+  if (!IsInline() && (refs_ == nullptr || --*refs_ == 0)) {
+    if (external_ == nullptr)
+      S21Allocator::Free(matrix_, rows_capacity_, cols_capacity_, policy_);
+    else if (*external_ && matrix_ != nullptr)
+      (*external_)(matrix_);
+    delete external_;
+    delete refs_;
   }
+  matrix_ = nullptr;
+  refs_ = nullptr;
+  external_ = nullptr;
+  rows_capacity_ = 0;
+  cols_capacity_ = 0;
+}
+
+/// @brief Делает текущую матрицу ещё одним владельцем буфера other
+void S21Matrix::ShareMem(const S21Matrix &other) noexcept {
+  ++*other.refs_;
+  rows_ = other.rows_;
+  cols_ = other.cols_;
+  rows_capacity_ = other.rows_capacity_;
+  cols_capacity_ = other.cols_capacity_;
+  matrix_ = other.matrix_;
+  refs_ = other.refs_;
+  external_ = other.external_;
+  policy_ = other.policy_;
+}
+
+/// @brief Отделение от разделяемого буфера перед изменением: матрица
+/// получает собственную копию, если у буфера есть другие владельцы
+void S21Matrix::Detach() {
+  Invalidate();
+  if (IsShared()) Reallocate(rows_capacity_, cols_capacity_);
+}
+
+/// @brief Сброс кеша производных результатов перед изменением матрицы
+void S21Matrix::Invalidate() noexcept {
+  if (!cache_) return;
+  std::unique_ptr<S21DerivedCache> stale;
+  {
+    std::lock_guard<std::mutex> lock(CacheMutex(&cache_));
+    stale = std::move(cache_);
+  }
+  ++cache_invalidations;
+}
+
+/// @brief LU-разложение текущей матрицы (из кеша, если он включён)
+std::shared_ptr<const S21LuFactor> S21Matrix::Lu() {
+  return Memoize(&cache_, &S21DerivedCache::lu, [this] {
+    return std::shared_ptr<const S21LuFactor>(
+        std::make_shared<S21LuFactor>(*this));
+  });
 }
 
 bool S21Matrix::EqMatrix(const S21Matrix &other) const {
@@ -135,9 +585,9 @@ bool S21Matrix::EqMatrix(const S21Matrix &other) const {
   CheckMatrix(*this);
   CheckMatrix(other);
   if (rows_ == other.rows_ && cols_ == other.cols_ && matrix_ != nullptr) {
-    for (int i = 0; i < rows_; ++i) {
-      for (int j = 0; j < cols_; ++j) {
-        if ((int)(matrix_[i][j] * pow(10, 7)) !=
+    for (std::int64_t i = 0; i < rows_; ++i) {
+      for (std::int64_t j = 0; j < cols_; ++j) {
+        if ((int)(Row(i)[j] * pow(10, 7)) !=
             (int)(other(i, j) * pow(10, 7))) {
           result = false;
         }
@@ -155,11 +605,15 @@ void S21Matrix::SumMatrix(const S21Matrix &other) {
   CheckMatrix(*this);
   CheckMatrix(other);
 
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      matrix_[i][j] += other(i, j);
+  Detach();
+  ForRows(rows_, cols_, [this, &other, cols = cols_](std::int64_t from,
+                                                     std::int64_t to) {
+    for (std::int64_t i = from; i < to; ++i) {
+      const double *other_row = other.Row(i);
+      double *row = Row(i);
+      for (std::int64_t j = 0; j < cols; ++j) row[j] += other_row[j];
     }
-  }
+  });
 }
 
 void S21Matrix::SubMatrix(const S21Matrix &other) {
@@ -168,11 +622,15 @@ void S21Matrix::SubMatrix(const S21Matrix &other) {
   CheckMatrix(*this);
   CheckMatrix(other);
 
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      matrix_[i][j] -= other(i, j);
+  Detach();
+  ForRows(rows_, cols_, [this, &other, cols = cols_](std::int64_t from,
+                                                     std::int64_t to) {
+    for (std::int64_t i = from; i < to; ++i) {
+      const double *other_row = other.Row(i);
+      double *row = Row(i);
+      for (std::int64_t j = 0; j < cols; ++j) row[j] -= other_row[j];
     }
-  }
+  });
 }
 
 void S21Matrix::MulNumber(const double num) {
@@ -180,14 +638,20 @@ void S21Matrix::MulNumber(const double num) {
   if (num == INFINITY || num == NAN)
     throw std::length_error("Недопустимое число");
 
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      matrix_[i][j] *= num;
+  Detach();
+  // Копии в лямбде: запись в строку не может изменить num и cols_, и
+  // компилятор векторизует цикл
+  ForRows(rows_, cols_, [this, num, cols = cols_](std::int64_t from,
+                                                  std::int64_t to) {
+    for (std::int64_t i = from; i < to; ++i) {
+      double *row = Row(i);
+      for (std::int64_t j = 0; j < cols; ++j) row[j] *= num;
     }
-  }
+  });
 }
 
 void S21Matrix::MulMatrix(const S21Matrix &other) {
+  S21MemoryScope scope("MulMatrix");
   if (cols_ != other.rows_)
     throw std::length_error(
         "число столбцов первой матрицы не равно числу строк второй матрицы");
@@ -195,46 +659,139 @@ void S21Matrix::MulMatrix(const S21Matrix &other) {
   CheckMatrix(other);
 
   S21Matrix temp = S21Matrix(rows_, other.cols_);
-  for (int i = 0; i < temp.rows_; ++i) {
-    for (int j = 0; j < temp.cols_; ++j) {
-      for (int k = 0; k < cols_; k++) {
-        temp(i, j) += (matrix_[i][k] * other(k, j));
-      }
-    }
+  temp.Gemm(1.0, *this, other, 0.0);
+  *this = std::move(temp);
+}
+
+/// @brief Обобщённое умножение: this = alpha * op(a) * op(b) + beta * this.
+/// Считается за один проход без промежуточных матриц. Если текущая матрица
+/// совпадает с одним из множителей, результат считается во временную
+/// @param trans_a если true, вместо a берётся a^T
+/// @param trans_b если true, вместо b берётся b^T
+void S21Matrix::Gemm(double alpha, const S21Matrix &a, const S21Matrix &b,
+                     double beta, bool trans_a, bool trans_b) {
+  CheckMatrix(a);
+  CheckMatrix(b);
+  std::int64_t m = trans_a ? a.cols_ : a.rows_;
+  std::int64_t k = trans_a ? a.rows_ : a.cols_;
+  std::int64_t n = trans_b ? b.rows_ : b.cols_;
+  if (k != (trans_b ? b.cols_ : b.rows_))
+    throw std::length_error(
+        "число столбцов первой матрицы не равно числу строк второй матрицы");
+  if (rows_ != m || cols_ != n)
+    throw std::length_error("Разная размерность матриц");
+
+  if (this == &a || this == &b) {
+    S21Matrix temp(*this);
+    temp.Gemm(alpha, a, b, beta, trans_a, trans_b);
+    *this = std::move(temp);
+  } else {
+    Detach();
+    s21_kernels::Gemm(m, n, k, alpha, a.matrix_, a.cols_capacity_, trans_a,
+                      b.matrix_, b.cols_capacity_, trans_b, beta, matrix_,
+                      cols_capacity_);
   }
-  *this = temp;
+}
+
+/// @brief this = this + alpha * x
+void S21Matrix::Axpy(double alpha, const S21Matrix &x) {
+  if (cols_ != x.cols_ || rows_ != x.rows_)
+    throw std::length_error("Разная размерность матриц");
+  CheckMatrix(*this);
+  CheckMatrix(x);
+
+  Detach();
+  ForRows(rows_, cols_, [this, &x, alpha, cols = cols_](std::int64_t from,
+                                                        std::int64_t to) {
+    for (std::int64_t i = from; i < to; ++i) {
+      const double *x_row = x.Row(i);
+      double *row = Row(i);
+      for (std::int64_t j = 0; j < cols; ++j) row[j] += alpha * x_row[j];
+    }
+  });
+}
+
+/// @brief this = alpha * this
+void S21Matrix::Scal(double alpha) {
+  CheckMatrix(*this);
+
+  Detach();
+  ForRows(rows_, cols_, [this, alpha, cols = cols_](std::int64_t from,
+                                                    std::int64_t to) {
+    for (std::int64_t i = from; i < to; ++i) {
+      double *row = Row(i);
+      for (std::int64_t j = 0; j < cols; ++j) row[j] *= alpha;
+    }
+  });
+}
+
+/// @brief Обновление ранга 1: this = this + alpha * x * y^T
+/// @param x столбец размером rows x 1
+/// @param y столбец размером cols x 1
+void S21Matrix::Ger(double alpha, const S21Matrix &x, const S21Matrix &y) {
+  if (x.rows_ != rows_ || x.cols_ != 1 || y.rows_ != cols_ || y.cols_ != 1)
+    throw std::length_error("Разная размерность матриц");
+  CheckMatrix(*this);
+  CheckMatrix(x);
+  CheckMatrix(y);
+
+  Detach();
+  ForRows(rows_, cols_, [this, &x, &y, alpha](std::int64_t from,
+                                              std::int64_t to) {
+    s21_kernels::Ger(to - from, cols_, alpha, x.Row(from), x.cols_capacity_,
+                     y.matrix_, y.cols_capacity_, Row(from), cols_capacity_);
+  });
 }
 
 /// @brief Транспонирование матрица (создаётся новая)
 S21Matrix S21Matrix::Transpose() {
+  S21MemoryScope scope("Transpose");
   CheckMatrix(*this);
 
-  S21Matrix result_matrix = S21Matrix(cols_, rows_);
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      result_matrix(j, i) = matrix_[i][j];
-    }
-  }
-  return result_matrix;
+  return Memoize(&cache_, &S21DerivedCache::transpose, [this] {
+    S21Matrix result_matrix = S21Matrix(cols_, rows_);
+    // Куски делят столбцы исходной матрицы (строки результата), внутри -
+    // квадратные блоки, чтобы чтение по столбцам не выходило из кэша
+    ForColumns(rows_, cols_, [&](std::int64_t from, std::int64_t to) {
+      for (std::int64_t j0 = from; j0 < to; j0 += kTransposeBlock) {
+        std::int64_t j1 = std::min<std::int64_t>(j0 + kTransposeBlock, to);
+        for (std::int64_t i0 = 0; i0 < rows_; i0 += kTransposeBlock) {
+          std::int64_t i1 = std::min<std::int64_t>(i0 + kTransposeBlock, rows_);
+          for (std::int64_t j = j0; j < j1; ++j) {
+            double *row = result_matrix.Row(j);
+            for (std::int64_t i = i0; i < i1; ++i) row[i] = Row(i)[j];
+          }
+        }
+      }
+    });
+    return result_matrix;
+  });
 }
 
 double S21Matrix::Determinant() {
+  S21MemoryScope scope("Determinant");
   if (cols_ != rows_) throw std::length_error("матрица не является квадратной");
   CheckMatrix(*this);
 
-  double result = 0;
-  CheckDet(&result);
-  return result;
+  return Memoize(&cache_, &S21DerivedCache::determinant, [this] {
+    double result = 0;
+    if (rows_ >= kLuThreshold)
+      result = Lu()->Determinant();
+    else
+      CheckDet(&result);
+    return result;
+  });
 }
 
 S21Matrix S21Matrix::CalcComplements() {
+  S21MemoryScope scope("CalcComplements");
   if (cols_ != rows_) throw std::length_error("матрица не является квадратной");
   CheckMatrix(*this);
 
   double min = 0;
   S21Matrix result_matrix = S21Matrix(rows_, cols_);
   if (cols_ == 1) {
-    result_matrix(0, 0) = matrix_[0][0];
+    result_matrix(0, 0) = Row(0)[0];
   } else {
     S21Matrix current_matrix = S21Matrix(cols_ - 1, rows_ - 1);
     for (int i = 0; i < result_matrix.rows_; ++i) {
@@ -250,23 +807,116 @@ S21Matrix S21Matrix::CalcComplements() {
 }
 
 S21Matrix S21Matrix::InverseMatrix() {
-  double det = Determinant();
-  if (abs(det) < kzero) throw std::length_error("определитель матрицы равен 0");
-  CheckMatrix(*this);
-  S21Matrix result_matrix;
+  S21MemoryScope scope("InverseMatrix");
+  return Memoize(&cache_, &S21DerivedCache::inverse, [this]() -> S21Matrix {
+    if (cols_ == rows_ && rows_ >= kLuThreshold) {
+      std::shared_ptr<const S21LuFactor> lu = Lu();
+      if (lu->IsSingular())
+        throw std::length_error("определитель матрицы равен 0");
+      return lu->Inverse();
+    }
+    // Вырожденность проверяется относительно оценки Адамара (произведения
+    // норм строк), а не абсолютным порогом, зависящим от масштаба
+    double det = Determinant(), bound = 1;
+    for (int i = 0; i < rows_; ++i) {
+      double norm = 0;
+      for (int j = 0; j < cols_; ++j) norm += Row(i)[j] * Row(i)[j];
+      bound *= sqrt(norm);
+    }
+    if (fabs(det) <= static_cast<double>(rows_) *
+                         std::numeric_limits<double>::epsilon() * bound)
+      throw std::length_error("определитель матрицы равен 0");
+    CheckMatrix(*this);
+    S21Matrix result_matrix;
 
-  if (cols_ == 1) {
-    result_matrix = S21Matrix(cols_, rows_);
-    result_matrix(0, 0) = 1.0 / matrix_[0][0];
-  } else {
-    result_matrix = CalcComplements().Transpose();
-    for (int i = 0; i < result_matrix.rows_; ++i) {
-      for (int j = 0; j < result_matrix.cols_; ++j) {
-        result_matrix(i, j) *= (1 / det);
+    if (cols_ == 1) {
+      result_matrix = S21Matrix(cols_, rows_);
+      result_matrix(0, 0) = 1.0 / Row(0)[0];
+    } else {
+      result_matrix = CalcComplements().Transpose();
+      for (int i = 0; i < result_matrix.rows_; ++i) {
+        for (int j = 0; j < result_matrix.cols_; ++j) {
+          result_matrix(i, j) *= (1 / det);
+        }
       }
     }
-  }
-  return result_matrix;
+    return result_matrix;
+  });
+}
+
+/// @brief Решение системы линейных уравнений this * x = b через LU-разложение
+/// @param b матрица правых частей, по столбцу на каждую систему
+S21Matrix S21Matrix::Solve(const S21Matrix &b) {
+  S21MemoryScope scope("Solve");
+  return Lu()->Solve(b);
+}
+
+/// @brief Решение this * x = b со смешанной точностью: разложение в float,
+/// уточнение невязки в double до точности double
+S21Matrix S21Matrix::SolveMixed(const S21Matrix &b) {
+  S21MemoryScope scope("SolveMixed");
+  return S21LuFactor::SolveMixed(*this, b);
+}
+
+/// @brief Решение задачи наименьших квадратов min ||this * x - b|| через
+/// QR-разложение (см. S21QrFactor)
+S21Matrix S21Matrix::LeastSquares(const S21Matrix &b) {
+  S21MemoryScope scope("LeastSquares");
+  return S21QrFactor(*this).LeastSquares(b);
+}
+
+/// @brief Обратная матрица со смешанной точностью (см. SolveMixed)
+S21Matrix S21Matrix::InverseMatrixMixed() {
+  if (cols_ != rows_) throw std::length_error("матрица не является квадратной");
+  S21Matrix identity(rows_, cols_);
+  for (int i = 0; i < rows_; ++i) identity.Row(i)[i] = 1;
+  return SolveMixed(identity);
+}
+
+// Асинхронные операции
+/* Асинхронные методы не изменяют текущую матрицу, а возвращают future с
+результатом. Операнды не копируются, поэтому они должны существовать и не
+изменяться, пока future не будет готов. Ошибки (например, разная размерность)
+пробрасываются из future::get() */
+
+std::future<S21Matrix> S21Matrix::SumMatrixAsync(const S21Matrix &other,
+                                                 S21CancellationToken token) {
+  return S21AsyncExecutor::Instance().Submit(
+      [this, &other] { return *this + other; }, token);
+}
+
+std::future<S21Matrix> S21Matrix::SubMatrixAsync(const S21Matrix &other,
+                                                 S21CancellationToken token) {
+  return S21AsyncExecutor::Instance().Submit(
+      [this, &other] { return *this - other; }, token);
+}
+
+std::future<S21Matrix> S21Matrix::MulMatrixAsync(const S21Matrix &other,
+                                                 S21CancellationToken token) {
+  return S21AsyncExecutor::Instance().Submit(
+      [this, &other] { return *this * other; }, token);
+}
+
+std::future<S21Matrix> S21Matrix::TransposeAsync(S21CancellationToken token) {
+  return S21AsyncExecutor::Instance().Submit([this] { return Transpose(); },
+                                             token);
+}
+
+std::future<double> S21Matrix::DeterminantAsync(S21CancellationToken token) {
+  return S21AsyncExecutor::Instance().Submit([this] { return Determinant(); },
+                                             token);
+}
+
+std::future<S21Matrix> S21Matrix::InverseMatrixAsync(
+    S21CancellationToken token) {
+  return S21AsyncExecutor::Instance().Submit(
+      [this] { return InverseMatrix(); }, token);
+}
+
+std::future<S21Matrix> S21Matrix::SolveAsync(const S21Matrix &b,
+                                             S21CancellationToken token) {
+  return S21AsyncExecutor::Instance().Submit([this, &b] { return Solve(b); },
+                                             token);
 }
 
 // Перерузка операторов
@@ -278,9 +928,18 @@ S21Matrix S21Matrix::InverseMatrix() {
 /// копирования
 S21Matrix &S21Matrix::operator=(const S21Matrix &other) {
   if (this != &other) {
-    DeleteMem();
-    AlocateMem(other.rows_, other.cols_);
-    CopyMatrixData(other);
+    Invalidate();
+    if (other.refs_ != nullptr && copy_on_write) {
+      DeleteMem();
+      ShareMem(other);
+    } else {
+      if (IsShared() || rows_capacity_ < other.rows_ ||
+          cols_capacity_ < other.cols_) {
+        DeleteMem();
+        AlocateMem(other.rows_, other.cols_);
+      }
+      CopyMatrixData(other);
+    }
   }
   return *this;
 }
@@ -290,9 +949,18 @@ S21Matrix &S21Matrix::operator=(const S21Matrix &other) {
 S21Matrix &S21Matrix::operator=(S21Matrix &&other) {
   if (this != &other) {
     DeleteMem();
+    rows_ = 0;
+    cols_ = 0;
     std::swap(cols_, other.cols_);
     std::swap(rows_, other.rows_);
+    std::swap(cols_capacity_, other.cols_capacity_);
+    std::swap(rows_capacity_, other.rows_capacity_);
     std::swap(matrix_, other.matrix_);
+    std::swap(policy_, other.policy_);
+    std::swap(refs_, other.refs_);
+    std::swap(external_, other.external_);
+    AdoptInline(&other);
+    cache_ = std::move(other.cache_);
   }
   return *this;
 }
@@ -310,8 +978,13 @@ S21Matrix S21Matrix::operator-(const S21Matrix &other) {
 }
 
 S21Matrix S21Matrix::operator*(const S21Matrix &other) {
-  S21Matrix mult = S21Matrix(*this);
-  mult.MulMatrix(other);
+  if (cols_ != other.rows_)
+    throw std::length_error(
+        "число столбцов первой матрицы не равно числу строк второй матрицы");
+  CheckMatrix(*this);
+
+  S21Matrix mult = S21Matrix(rows_, other.cols_);
+  mult.Gemm(1.0, *this, other, 0.0);
   return mult;
 }
 
@@ -354,32 +1027,32 @@ S21Matrix &S21Matrix::operator*=(const double numb) {
 }
 
 // Перегрузка оператора индексации для чтения элемента (когда const)
-double S21Matrix::operator()(int i, int j) const {
+double S21Matrix::operator()(std::int64_t i, std::int64_t j) const {
   if (i < 0 || i >= rows_ || j < 0 || j >= cols_)
     throw std::length_error("индекс за пределами матрицы");
 
-  return matrix_[i][j];
+  return Row(i)[j];
 }
 
 // Перегрузка оператора индексации для записи элемента
-double &S21Matrix::operator()(int i, int j) {
+double &S21Matrix::operator()(std::int64_t i, std::int64_t j) {
   if (i < 0 || i >= rows_ || j < 0 || j >= cols_)
     throw std::length_error("индекс за пределами матрицы");
 
-  return matrix_[i][j];
+  Detach();
+  return Row(i)[j];
 }
 
 /// @brief Метод копирует данные (размерность и значения) матрицы из одного
 /// объекта в другой
 /// @param other Матрица, откуда копируются данные
-void S21Matrix::CopyMatrixData(const S21Matrix &other) noexcept {
+void S21Matrix::CopyMatrixData(const S21Matrix &other) {
   cols_ = other.cols_;
   rows_ = other.rows_;
-  for (int i = 0; i < rows_; ++i) {  // копирование элементов матрицы
-    for (int j = 0; j < cols_; ++j) {
-      matrix_[i][j] = other(i, j);
-    }
-  }
+  ForRows(rows_, cols_, [&](std::int64_t from, std::int64_t to) {
+    for (std::int64_t i = from; i < to; ++i)  // копирование элементов матрицы
+      std::copy(other.Row(i), other.Row(i) + cols_, Row(i));
+  });
 }
 
 /// @brief Проверка размерности матрицы, в зависимости от этого разные методы
@@ -387,9 +1060,9 @@ void S21Matrix::CopyMatrixData(const S21Matrix &other) noexcept {
 /// @param result
 void S21Matrix::CheckDet(double *result) noexcept {
   if (cols_ == 1)  // если матрица из одного элемента
-    *result = matrix_[0][0];
+    *result = Row(0)[0];
   if (cols_ == 2)  // если матрица из двух элементов
-    *result = (matrix_[0][0] * matrix_[1][1]) - (matrix_[0][1] * matrix_[1][0]);
+    *result = (Row(0)[0] * Row(1)[1]) - (Row(0)[1] * Row(1)[0]);
   if (cols_ >= 3) {
     DetOverThree(result);
   }
@@ -398,7 +1071,7 @@ void S21Matrix::CheckDet(double *result) noexcept {
 /// @brief Метод подсчёта определителя для матриц размерностью 3 и больше
 /// (рекурсивный)
 /// @param result Определитель
-void S21Matrix::DetOverThree(double *result) noexcept {
+void S21Matrix::DetOverThree(double *result) {
   int sign = -1;
   double det = 0;
   S21Matrix new_matrix = S21Matrix(rows_ - 1, cols_ - 1);
@@ -409,7 +1082,7 @@ void S21Matrix::DetOverThree(double *result) noexcept {
               0);  // создаём матрицу с вырезанной строчкой и столбцом (минор)
     sign *= (-1);
     new_matrix.CheckDet(&det);
-    *result += sign * matrix_[0][i] * det;
+    *result += sign * Row(0)[i] * det;
   }
 }
 
@@ -422,7 +1095,7 @@ void S21Matrix::Minorchik(S21Matrix *matrix, int n, int m) noexcept {
        ++i) {  // ki и kj номера строк в минорной матрице
     for (int j = 0; j < this->cols_; ++j) {
       if (i == m || j == n) continue;
-      matrix->matrix_[ki][kj] = matrix_[i][j];
+      matrix->Row(ki)[kj] = Row(i)[j];
       ++kj;
     }
     if (i == m) continue;
@@ -431,18 +1104,45 @@ void S21Matrix::Minorchik(S21Matrix *matrix, int n, int m) noexcept {
   }
 }
 
+/// @brief Проверка, что other непустая и того же размера, что и текущая
+void S21Matrix::CheckSameSize(const S21Matrix &other) const {
+  CheckMatrix(*this);
+  CheckMatrix(other);
+  if (cols_ != other.cols_ || rows_ != other.rows_)
+    throw std::length_error("Разная размерность матриц");
+}
+
+/// @brief Вызывает body(from, to) для кусков строк длины
+/// S21ThreadPool::ChunkLength(cols): для больших матриц в пуле потоков, иначе
+/// по порядку в текущем потоке. Куски не зависят от числа потоков и порога,
+/// поэтому свёртки по кускам дают одинаковый результат при любых настройках
+void S21Matrix::ForRows(
+    std::int64_t rows, std::int64_t cols,
+    const std::function<void(std::int64_t, std::int64_t)> &body) {
+  std::int64_t chunk = S21ThreadPool::ChunkLength(cols);
+  if (rows * cols < parallel_threshold.load()) {
+    for (std::int64_t from = 0; from < rows; from += chunk)
+      body(from, std::min(rows, from + chunk));
+    return;
+  }
+  S21ThreadPool::Instance().ParallelChunks(rows, chunk, body);
+}
+
+/// @brief Вызывает body(from, to) для кусков столбцов матрицы rows x cols.
+/// Столбцы делятся группами по кэш-линии, чтобы кусок не читал из каждой
+/// строки по одному элементу
+void S21Matrix::ForColumns(
+    std::int64_t rows, std::int64_t cols,
+    const std::function<void(std::int64_t, std::int64_t)> &body) {
+  constexpr std::int64_t kGroup = 8;
+  ForRows((cols + kGroup - 1) / kGroup, rows * kGroup,
+          [&](std::int64_t from, std::int64_t to) {
+            body(from * kGroup, std::min(cols, to * kGroup));
+          });
+}
+
 /// @brief Проверка матрицы на пустоту или неправильное определение
 void S21Matrix::CheckMatrix(const S21Matrix &other) const {
   if (other.cols_ <= 0 || other.rows_ <= 0 || other.matrix_ == nullptr)
     throw std::length_error("матрица пустая");
 }
-
-/// @brief Процедура печати матрицы
-void S21Matrix::PrintMatrix() const noexcept {
-  for (int i = 0; i <= rows_ - 1; ++i) {
-    for (int j = 0; j <= cols_ - 1; ++j) {
-      std::cout << matrix_[i][j] << " ";
-    }
-    std::cout << std::endl;
-  }
-}
\ No newline at end of file
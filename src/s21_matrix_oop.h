@@ -1,22 +1,126 @@
 #ifndef S21_MATRIX_OOP
 #define S21_MATRIX_OOP
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <iosfwd>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "s21_async.h"
+#include "s21_memory.h"
+
+struct S21DerivedCache;
+class S21LuFactor;
+class S21Vector;
+
+/// @brief Результат свёртки всех элементов матрицы за один проход
+struct S21Reduction {
+  double sum = 0;
+  double sum_squares = 0;
+  double max_abs = 0;
+  double min = std::numeric_limits<double>::infinity();
+  double max = -std::numeric_limits<double>::infinity();
+  std::int64_t argmin_row = -1, argmin_col = -1;
+  std::int64_t argmax_row = -1, argmax_col = -1;
+};
+
+/// @brief Порядок элементов во внешнем буфере
+enum class S21Layout { kRowMajor, kColMajor };
+
+/// @brief Освобождение внешнего буфера, не должно бросать исключений
+using S21Deleter = std::function<void(double*)>;
+
+/// @brief Буфер, отданный матрицей через Release(). Новый владелец
+/// освобождает его вызовом deleter(data), если deleter задан
+struct S21Buffer {
+  double* data = nullptr;
+  std::int64_t rows = 0, cols = 0;
+  std::int64_t stride = 0;  // Шаг между соседними строками
+  S21Deleter deleter;
+};
+
+/// @brief Статистика кеша производных результатов (см. SetCaching)
+struct S21CacheStats {
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+  std::size_t invalidations = 0;
+};
+
 class S21Matrix {
+  friend class S21LuFactor;
+  friend class S21QrFactor;
+  friend class S21TriangularMatrix;
+  friend class S21SymmetricMatrix;
+  friend class S21BandMatrix;
+  friend class S21DistributedMatrix;
+  friend class S21Vector;
+  friend struct S21DerivedCache;
 
  public:
   S21Matrix() noexcept;  // Default constructor
-  explicit S21Matrix(int rows, int cols);
+  explicit S21Matrix(std::int64_t rows, std::int64_t cols);
   S21Matrix(const S21Matrix& other);
   S21Matrix(S21Matrix&& other) noexcept;
   ~S21Matrix();
 
-  // геттеры и сеттеры для private атрибутов
-  void SetRows(int numb);
-  void SetCols(int numb);
-  void SetMatrix(int numb, int row, int col);
+  // геттеры и сеттеры для private атрибутов. Размерности 64-битные, а
+  // GetRows и GetCols оставлены для совместимости и бросают исключение,
+  // если размерность не помещается в int
+  void SetRows(std::int64_t numb);
+  void SetCols(std::int64_t numb);
+  void SetMatrix(int numb, std::int64_t row, std::int64_t col);
   int GetRows() const;
   int GetCols() const;
-  double GetMatrix(int row, int col) const;
+  std::int64_t GetRows64() const noexcept;
+  std::int64_t GetCols64() const noexcept;
+  double GetMatrix(std::int64_t row, std::int64_t col) const;
+
+  // управление зарезервированной памятью (как у std::vector)
+  void Reserve(std::int64_t rows, std::int64_t cols);
+  void ShrinkToFit();
+  std::int64_t GetRowsCapacity() const;
+  std::int64_t GetColsCapacity() const;
+  void AppendRow(const S21Matrix& row);
+  void RemoveRow(std::int64_t row);
+
+  // матрица поверх внешнего буфера без копирования; Borrow принимает
+  // только построчный буфер, буфер по столбцам можно передать в Adopt
+  static S21Matrix Adopt(double* data, std::int64_t rows, std::int64_t cols,
+                         S21Deleter deleter,
+                         S21Layout layout = S21Layout::kRowMajor,
+                         std::int64_t stride = 0);
+  static S21Matrix Borrow(double* data, std::int64_t rows, std::int64_t cols,
+                          std::int64_t stride = 0);
+  S21Buffer Release();
+  bool IsExternal() const;
+
+  // порог в элементах, начиная с которого поэлементные операции,
+  // копирование, транспонирование и обнуление идут в пуле потоков
+  static void SetParallelThreshold(long long elements);
+  static long long GetParallelThreshold();
+
+  // политика выделения памяти (большие страницы, NUMA)
+  void SetAllocPolicy(const S21AllocPolicy& policy);
+  S21AllocPolicy GetAllocPolicy() const;
+
+  // копирование при записи: копии разделяют буфер до первого изменения
+  static void SetCopyOnWrite(bool enabled);
+  static bool GetCopyOnWrite();
+  bool IsShared() const;
+
+  // кеш LU-разложения, определителя, обратной и транспонированной матриц,
+  // сбрасывается при любом изменении матрицы
+  static void SetCaching(bool enabled);
+  static bool GetCaching();
+  static S21CacheStats GetCacheStats();
+  static void ResetCacheStats();
 
   // основные функции
   void SumMatrix(const S21Matrix& other);
@@ -28,6 +132,76 @@ class S21Matrix {
   S21Matrix CalcComplements();
   double Determinant();
   S21Matrix InverseMatrix();
+  S21Matrix Solve(const S21Matrix& b);
+  S21Matrix SolveMixed(const S21Matrix& b);
+  S21Matrix InverseMatrixMixed();
+  S21Matrix LeastSquares(const S21Matrix& b);
+
+  // точные алгоритмы для матриц из целых чисел
+  std::int64_t DeterminantInt() const;
+  std::string DeterminantExact() const;
+  int RankExact() const;
+
+  // BLAS-подобные операции без временных матриц, результат пишется в текущую
+  void Gemm(double alpha, const S21Matrix& a, const S21Matrix& b, double beta,
+            bool trans_a = false, bool trans_b = false);
+  void Axpy(double alpha, const S21Matrix& x);
+  void Scal(double alpha);
+  void Ger(double alpha, const S21Matrix& x, const S21Matrix& y);
+  void Ger(double alpha, const S21Vector& x, const S21Vector& y);
+
+  // поэлементные преобразования с пользовательской функцией: на месте или
+  // в заранее выделенную матрицу того же размера
+  template <typename F>
+  S21Matrix& Apply(F f);
+  template <typename F>
+  S21Matrix Map(F f) const;
+  template <typename F>
+  void Map(F f, S21Matrix* destination) const;
+  template <typename F>
+  S21Matrix& Zip(const S21Matrix& other, F f);
+  template <typename F>
+  void Zip(const S21Matrix& other, F f, S21Matrix* destination) const;
+  template <typename F>
+  S21Matrix& Zip3(const S21Matrix& b, const S21Matrix& c, F f);
+  template <typename F>
+  void Zip3(const S21Matrix& b, const S21Matrix& c, F f,
+            S21Matrix* destination) const;
+
+  // свёртки: большие матрицы обрабатываются в пуле потоков
+  S21Reduction Reduce() const;
+  double Sum() const;
+  double Min() const;
+  double Max() const;
+  std::pair<int, int> ArgMin() const;
+  std::pair<int, int> ArgMax() const;
+  double Trace() const;
+  double NormFrobenius() const;
+  double Norm1() const;
+  double NormInf() const;
+  S21Matrix RowSums() const;
+  S21Matrix ColSums() const;
+
+  // степень и экспонента квадратной матрицы
+  S21Matrix Pow(int k);
+  S21Matrix Exp();
+
+  // произведение цепочки матриц в оптимальном порядке
+  static S21Matrix MultiplyChain(
+      const std::vector<std::reference_wrapper<const S21Matrix>>& chain);
+
+  // асинхронные версии операций, выполняются в пуле потоков библиотеки
+  std::future<S21Matrix> SumMatrixAsync(
+      const S21Matrix& other, S21CancellationToken token = {});
+  std::future<S21Matrix> SubMatrixAsync(
+      const S21Matrix& other, S21CancellationToken token = {});
+  std::future<S21Matrix> MulMatrixAsync(
+      const S21Matrix& other, S21CancellationToken token = {});
+  std::future<S21Matrix> TransposeAsync(S21CancellationToken token = {});
+  std::future<double> DeterminantAsync(S21CancellationToken token = {});
+  std::future<S21Matrix> InverseMatrixAsync(S21CancellationToken token = {});
+  std::future<S21Matrix> SolveAsync(const S21Matrix& b,
+                                    S21CancellationToken token = {});
 
   // перегрузка операторов
   S21Matrix& operator=(const S21Matrix& other);
@@ -42,26 +216,157 @@ class S21Matrix {
   S21Matrix& operator-=(const S21Matrix& other);
   S21Matrix& operator*=(const S21Matrix& other);
   S21Matrix& operator*=(const double numb);
-  double operator()(int i, int j) const;
-  double& operator()(int i, int j);
+  double operator()(std::int64_t i, std::int64_t j) const;
+  double& operator()(std::int64_t i, std::int64_t j);
 
+  // текстовый ввод-вывод: строка матрицы на строку текста
   void PrintMatrix() const noexcept;
+  void WriteText(std::ostream& out, char delimiter = ' ') const;
+  void WriteText(int fd, char delimiter = ' ') const;
+  static S21Matrix ParseText(std::string_view text);
+  static S21Matrix ReadText(std::istream& in);
+  static S21Matrix ReadTextFile(const std::string& path);
 
  private:
-  const double kzero = 1e-9;
-  int rows_, cols_;  // Строки и колонки
-  double** matrix_;  // Указатель, где в памяти расположена матрица
+  // Начиная с этого размера определитель и обратная считаются через LU
+  static constexpr int kLuThreshold = 4;
+  // Матрицы до этого числа элементов хранятся в самом объекте без кучи
+  static constexpr int kInlineElements = 16;
+  std::int64_t rows_, cols_;  // Строки и колонки
+  // Зарезервированные строки и колонки
+  std::int64_t rows_capacity_, cols_capacity_;
+  double* matrix_;  // Непрерывный буфер, строки идут с шагом cols_capacity_
+  S21AllocPolicy policy_;  // Политика, с которой выделен буфер
+  std::atomic<int>* refs_;  // Число владельцев буфера, если он разделяемый
+  // Освобождение внешнего буфера (пустое у заимствованного), nullptr, если
+  // буфер выделен S21Allocator
+  S21Deleter* external_;
+  std::unique_ptr<S21DerivedCache> cache_;  // Производные результаты
+  double inline_[kInlineElements];  // Буфер маленьких матриц
+
+  bool IsInline() const noexcept { return matrix_ == inline_; }
+
+  double* Row(std::int64_t i) const noexcept {
+    return matrix_ + i * cols_capacity_;
+  }
 
   // вспомогательные методы для работы с матрицами
-  void CopyMatrixData(const S21Matrix& other) noexcept;
+  void CopyMatrixData(const S21Matrix& other);
   void CheckMatrix(const S21Matrix& other) const;
   void CreateNullMatrix() noexcept;
-  void AlocateMem(int other_rows, int other_cols) noexcept;
+  void AlocateMem(std::int64_t other_rows, std::int64_t other_cols);
+  double* Acquire(std::int64_t rows_capacity, std::int64_t cols_capacity);
+  void AdoptInline(S21Matrix* other) noexcept;
+  void Reallocate(std::int64_t rows_capacity, std::int64_t cols_capacity);
   void DeleteMem() noexcept;
+  void ShareMem(const S21Matrix& other) noexcept;
+  void Detach();
+  void Invalidate() noexcept;
+  static S21Matrix External(double* data, std::int64_t rows, std::int64_t cols,
+                            std::int64_t stride, S21Deleter deleter);
+  std::shared_ptr<const S21LuFactor> Lu();
 
   // вспомогательные методы для нахождения определителя
   void CheckDet(double* result) noexcept;
-  void DetOverThree(double* result) noexcept;
+  void DetOverThree(double* result);
   void Minorchik(S21Matrix* matrix, int n, int m) noexcept;
+  void CheckSameSize(const S21Matrix& other) const;
+  static void ForRows(
+      std::int64_t rows, std::int64_t cols,
+      const std::function<void(std::int64_t, std::int64_t)>& body);
+  static void ForColumns(
+      std::int64_t rows, std::int64_t cols,
+      const std::function<void(std::int64_t, std::int64_t)>& body);
 };
+
+/// @brief this(i, j) = f(this(i, j)). Функция встраивается в цикл по
+/// непрерывной строке, большие матрицы делятся по строкам между потоками
+/// пула, поэтому f должна быть потокобезопасной
+template <typename F>
+S21Matrix& S21Matrix::Apply(F f) {
+  CheckMatrix(*this);
+  Detach();
+  ForRows(rows_, cols_, [&](std::int64_t from, std::int64_t to) {
+    for (std::int64_t i = from; i < to; ++i) {
+      double* row = Row(i);
+      for (std::int64_t j = 0; j < cols_; ++j) row[j] = f(row[j]);
+    }
+  });
+  return *this;
+}
+
+/// @brief Новая матрица из f(this(i, j))
+template <typename F>
+S21Matrix S21Matrix::Map(F f) const {
+  CheckMatrix(*this);
+  S21Matrix result(rows_, cols_);
+  Map(f, &result);
+  return result;
+}
+
+/// @brief destination(i, j) = f(this(i, j)), destination того же размера
+/// (может совпадать с this)
+template <typename F>
+void S21Matrix::Map(F f, S21Matrix* destination) const {
+  CheckSameSize(*destination);
+  destination->Detach();
+  ForRows(rows_, cols_, [&](std::int64_t from, std::int64_t to) {
+    for (std::int64_t i = from; i < to; ++i) {
+      const double* source = Row(i);
+      double* row = destination->Row(i);
+      for (std::int64_t j = 0; j < cols_; ++j) row[j] = f(source[j]);
+    }
+  });
+}
+
+/// @brief this(i, j) = f(this(i, j), other(i, j))
+template <typename F>
+S21Matrix& S21Matrix::Zip(const S21Matrix& other, F f) {
+  Zip(other, f, this);
+  return *this;
+}
+
+/// @brief destination(i, j) = f(this(i, j), other(i, j))
+template <typename F>
+void S21Matrix::Zip(const S21Matrix& other, F f,
+                    S21Matrix* destination) const {
+  CheckSameSize(other);
+  CheckSameSize(*destination);
+  destination->Detach();
+  ForRows(rows_, cols_, [&](std::int64_t from, std::int64_t to) {
+    for (std::int64_t i = from; i < to; ++i) {
+      const double* a = Row(i);
+      const double* b = other.Row(i);
+      double* row = destination->Row(i);
+      for (std::int64_t j = 0; j < cols_; ++j) row[j] = f(a[j], b[j]);
+    }
+  });
+}
+
+/// @brief this(i, j) = f(this(i, j), b(i, j), c(i, j))
+template <typename F>
+S21Matrix& S21Matrix::Zip3(const S21Matrix& b, const S21Matrix& c, F f) {
+  Zip3(b, c, f, this);
+  return *this;
+}
+
+/// @brief destination(i, j) = f(this(i, j), b(i, j), c(i, j))
+template <typename F>
+void S21Matrix::Zip3(const S21Matrix& b, const S21Matrix& c, F f,
+                     S21Matrix* destination) const {
+  CheckSameSize(b);
+  CheckSameSize(c);
+  CheckSameSize(*destination);
+  destination->Detach();
+  ForRows(rows_, cols_, [&](std::int64_t from, std::int64_t to) {
+    for (std::int64_t i = from; i < to; ++i) {
+      const double* x = Row(i);
+      const double* y = b.Row(i);
+      const double* z = c.Row(i);
+      double* row = destination->Row(i);
+      for (std::int64_t j = 0; j < cols_; ++j) row[j] = f(x[j], y[j], z[j]);
+    }
+  });
+}
+
 #endif  // S21_MATRIX_OOP
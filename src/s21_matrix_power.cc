@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+
+#include "s21_lu.h"
+#include "s21_matrix_oop.h"
+
+namespace {
+
+// Порядок диагональной аппроксимации Паде для экспоненты. При норме
+// матрицы не больше 1/2 его достаточно для точности double
+constexpr int kPadeOrder = 6;
+
+S21Matrix Identity(std::int64_t n) {
+  S21Matrix result(n, n);
+  for (std::int64_t i = 0; i < n; ++i) result(i, i) = 1;
+  return result;
+}
+
+}  // namespace
+
+/// @brief Возведение матрицы в целую степень двоичным алгоритмом: O(log k)
+/// умножений. Биты показателя проходятся от старшего к младшему, результат
+/// возводится в квадрат и при единичном бите умножается на исходную матрицу,
+/// так что временных буферов всего два: результат и буфер произведения.
+/// Отрицательная степень - это обратная матрица к положительной
+/// @param k показатель степени
+S21Matrix S21Matrix::Pow(int k) {
+  if (cols_ != rows_) throw std::length_error("матрица не является квадратной");
+  CheckMatrix(*this);
+
+  long long power = std::llabs(static_cast<long long>(k));
+  if (power == 0) return Identity(rows_);
+
+  int bit = 62;
+  while (!(power >> bit & 1)) --bit;
+  S21Matrix result(*this);
+  {
+    S21Matrix scratch(rows_, cols_);
+    for (--bit; bit >= 0; --bit) {
+      scratch.Gemm(1.0, result, result, 0.0);
+      std::swap(result, scratch);
+      if (power >> bit & 1) {
+        scratch.Gemm(1.0, result, *this, 0.0);
+        std::swap(result, scratch);
+      }
+    }
+  }
+  return k < 0 ? result.InverseMatrix() : result;
+}
+
+/// @brief Матричная экспонента методом масштабирования и возведения в
+/// квадрат: матрица делится на 2^s так, чтобы её норма стала не больше 1/2,
+/// экспонента уменьшенной матрицы приближается дробью Паде D^-1 * N
+/// (решается через LU), затем результат s раз возводится в квадрат
+S21Matrix S21Matrix::Exp() {
+  if (cols_ != rows_) throw std::length_error("матрица не является квадратной");
+  CheckMatrix(*this);
+
+  double norm = 0;
+  for (std::int64_t i = 0; i < rows_; ++i) {
+    double row_sum = 0;
+    for (std::int64_t j = 0; j < cols_; ++j) row_sum += std::fabs(Row(i)[j]);
+    // Без проверки NaN потерялся бы в std::max, а бесконечная норма дала бы
+    // неопределённое приведение логарифма к int
+    if (!std::isfinite(row_sum))
+      throw std::length_error("норма матрицы бесконечна или не определена");
+    norm = std::max(norm, row_sum);
+  }
+  int squarings = norm > 0.5 ? static_cast<int>(std::ceil(std::log2(norm))) + 1
+                             : 0;
+
+  S21Matrix a(*this);
+  a.Scal(std::ldexp(1.0, -squarings));
+  S21Matrix numerator = Identity(rows_);
+  S21Matrix denominator = Identity(rows_);
+  S21Matrix power(a);
+  S21Matrix scratch(rows_, cols_);
+  double c = 1;
+  for (int k = 1; k <= kPadeOrder; ++k) {
+    c *= static_cast<double>(kPadeOrder - k + 1) /
+         (k * (2 * kPadeOrder - k + 1));
+    if (k > 1) {
+      scratch.Gemm(1.0, a, power, 0.0);
+      std::swap(power, scratch);
+    }
+    numerator.Axpy(c, power);
+    denominator.Axpy(k % 2 ? -c : c, power);
+  }
+
+  S21Matrix result = S21LuFactor(denominator).Solve(numerator);
+  for (int i = 0; i < squarings; ++i) {
+    scratch.Gemm(1.0, result, result, 0.0);
+    std::swap(result, scratch);
+  }
+  return result;
+}
@@ -0,0 +1,355 @@
+#include "s21_memory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "s21_thread_pool.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Буферы от этого размера выделяются через mmap, если политика не обычная
+constexpr std::size_t kHugePageSize = 2 << 20;
+
+// Буферы от этого размера обнуляются потоками пула (см. S21Matrix::
+// SetParallelThreshold)
+std::atomic<std::size_t> parallel_touch_bytes((1 << 16) * sizeof(double));
+
+// Режимы mbind из <linux/mempolicy.h>
+constexpr int kMpolInterleave = 3;
+constexpr int kMpolLocal = 4;
+
+std::mutex default_policy_mutex;
+S21AllocPolicy default_policy;
+
+// Имя операции для выделений без S21MemoryScope
+constexpr const char* kUnscoped = "other";
+
+thread_local const char* current_operation = kUnscoped;
+
+std::atomic<std::size_t> live_bytes(0);
+std::atomic<std::size_t> peak_bytes(0);
+std::atomic<std::size_t> allocations(0);
+std::atomic<std::size_t> deallocations(0);
+std::atomic<std::size_t> memory_limit(0);
+
+std::mutex operations_mutex;
+std::map<std::string, S21OperationMemory> operations;
+
+// Обработчики вызываются под мьютексом, поэтому не должны выделять матрицы
+std::atomic<bool> has_hooks(false);
+std::mutex hooks_mutex;
+std::vector<std::pair<int, S21AllocHook>> hooks;
+int next_hook_id = 0;
+
+std::size_t Bytes(std::int64_t rows, std::int64_t cols) {
+  return static_cast<std::size_t>(rows) * cols * sizeof(double);
+}
+
+/// @brief Размер буфера с проверкой переполнения произведения размерностей
+std::size_t CheckedBytes(std::int64_t rows, std::int64_t cols) {
+  if (rows < 0 || cols < 0)
+    throw std::length_error(
+        "число столбцов и строк не может быть отрицательным");
+  constexpr std::size_t kMaxElements =
+      std::numeric_limits<std::size_t>::max() / sizeof(double);
+  if (rows != 0 && static_cast<std::size_t>(cols) > kMaxElements / rows)
+    throw std::length_error("размер матрицы слишком велик");
+  return Bytes(rows, cols);
+}
+
+/// @brief Нужен ли для буфера такого размера mmap. Решение зависит только от
+/// размера и политики, поэтому Free повторяет его без хранения флагов
+bool UseMmap(std::size_t bytes, const S21AllocPolicy& policy) {
+#ifdef __linux__
+  return bytes >= kHugePageSize &&
+         (policy.huge_pages != S21HugePages::kNone ||
+          policy.numa != S21NumaPolicy::kDefault);
+#else
+  (void)bytes;
+  (void)policy;
+  return false;
+#endif
+}
+
+std::size_t MappedBytes(std::size_t bytes) {
+  return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+}
+
+#ifdef __linux__
+/// @brief Маска узлов NUMA из /sys/devices/system/node/online
+/// (формат "0-3,5"). Если файла нет, используется только узел 0
+unsigned long OnlineNodes() {
+  unsigned long mask = 0;
+  std::ifstream file("/sys/devices/system/node/online");
+  std::string range;
+  while (std::getline(file, range, ',')) {
+    int first = std::stoi(range), last = first;
+    std::size_t dash = range.find('-');
+    if (dash != std::string::npos) last = std::stoi(range.substr(dash + 1));
+    for (int node = first; node <= last && node < 64; ++node)
+      mask |= 1UL << node;
+  }
+  return mask == 0 ? 1 : mask;
+}
+
+/// @brief Отображение, выровненное по размеру большой страницы
+void* MapAligned(std::size_t length) {
+  std::size_t padded = length + kHugePageSize;
+  void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED) return nullptr;
+  char* begin = static_cast<char*>(raw);
+  std::size_t head =
+      (kHugePageSize - reinterpret_cast<std::size_t>(begin) % kHugePageSize) %
+      kHugePageSize;
+  if (head > 0) munmap(begin, head);
+  munmap(begin + head + length, padded - head - length);
+  return begin + head;
+}
+
+void* MapBuffer(std::size_t length, const S21AllocPolicy& policy) {
+  void* data = nullptr;
+#ifdef MAP_HUGETLB
+  if (policy.huge_pages == S21HugePages::kExplicit) {
+    data = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data == MAP_FAILED) data = nullptr;
+  }
+#endif
+  if (data == nullptr) {
+    data = MapAligned(length);
+    if (data == nullptr) throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+    if (policy.huge_pages != S21HugePages::kNone)
+      madvise(data, length, MADV_HUGEPAGE);
+#endif
+  }
+  if (policy.numa != S21NumaPolicy::kDefault) {
+    unsigned long nodes = OnlineNodes();
+    if (policy.numa == S21NumaPolicy::kInterleave)
+      syscall(SYS_mbind, data, length, kMpolInterleave, &nodes,
+              sizeof(nodes) * 8, 0);
+    else
+      syscall(SYS_mbind, data, length, kMpolLocal, nullptr, 0, 0);
+  }
+  return data;
+}
+#endif
+
+/// @brief Обнуление буфера. При параллельном обнулении строки делятся между
+/// потоками так же, как в поэлементных операциях, и каждая страница
+/// размещается на узле потока, который затем с ней работает
+void Touch(double* data, std::int64_t rows, std::int64_t cols,
+           const S21AllocPolicy& policy) {
+  if (policy.parallel_first_touch &&
+      Bytes(rows, cols) >= parallel_touch_bytes.load()) {
+    // Куски той же длины, что у S21Matrix::ForRows, поэтому страницы
+    // обычно достаются потокам, которые потом обрабатывают эти строки
+    S21ThreadPool::Instance().ParallelChunks(
+        rows, S21ThreadPool::ChunkLength(cols),
+        [=](std::int64_t begin, std::int64_t end) {
+          std::memset(data + begin * cols, 0, Bytes(end - begin, cols));
+        });
+  } else {
+    std::memset(data, 0, Bytes(rows, cols));
+  }
+}
+
+/// @brief Возвращает буфер из bytes байт системе тем же способом, которым
+/// он был получен
+void ReleaseBuffer(double* data, std::size_t bytes,
+                   const S21AllocPolicy& policy) noexcept {
+#ifdef __linux__
+  if (UseMmap(bytes, policy)) {
+    munmap(data, MappedBytes(bytes));
+    return;
+  }
+#endif
+  delete[] data;
+}
+
+/// @brief Размер, который буфер на самом деле занимает в памяти
+std::size_t Footprint(std::int64_t rows, std::int64_t cols,
+                      const S21AllocPolicy& policy) {
+  std::size_t bytes = Bytes(rows, cols);
+  return UseMmap(bytes, policy) ? MappedBytes(bytes) : bytes;
+}
+
+/// @brief Резервирует bytes в счётчике занятой памяти с проверкой лимита
+void Reserve(std::size_t bytes) {
+  std::size_t live = live_bytes.fetch_add(bytes) + bytes;
+  std::size_t limit = memory_limit.load();
+  if (limit != 0 && live > limit) {
+    live_bytes.fetch_sub(bytes);
+    throw S21MemoryLimitExceeded(bytes, limit);
+  }
+  std::size_t peak = peak_bytes.load();
+  while (live > peak && !peak_bytes.compare_exchange_weak(peak, live)) {
+  }
+}
+
+void Notify(bool allocated, std::size_t bytes, std::size_t live) {
+  if (!has_hooks.load()) return;
+  S21AllocEvent event{allocated, bytes, current_operation, live};
+  std::lock_guard<std::mutex> lock(hooks_mutex);
+  for (const auto& hook : hooks) hook.second(event);
+}
+
+}  // namespace
+
+S21MemoryLimitExceeded::S21MemoryLimitExceeded(std::size_t requested,
+                                               std::size_t limit) noexcept
+    : requested_(requested), limit_(limit) {}
+
+const char* S21MemoryLimitExceeded::what() const noexcept {
+  return "превышен лимит памяти под матрицы";
+}
+
+std::size_t S21MemoryLimitExceeded::GetRequested() const noexcept {
+  return requested_;
+}
+
+std::size_t S21MemoryLimitExceeded::GetLimit() const noexcept {
+  return limit_;
+}
+
+S21MemoryScope::S21MemoryScope(const char* operation) noexcept
+    : previous_(current_operation) {
+  current_operation = operation;
+}
+
+S21MemoryScope::~S21MemoryScope() { current_operation = previous_; }
+
+/// @brief Операция, к которой сейчас относятся выделения на этом потоке
+const char* S21MemoryScope::Current() noexcept { return current_operation; }
+
+/// @brief Выделяет обнулённый буфер под rows x cols элементов
+/// @return nullptr для пустого буфера
+double* S21Allocator::Allocate(std::int64_t rows, std::int64_t cols,
+                               const S21AllocPolicy& policy) {
+  std::size_t bytes = CheckedBytes(rows, cols);
+  if (bytes == 0) return nullptr;
+
+  std::size_t footprint = Footprint(rows, cols, policy);
+  Reserve(footprint);
+  double* data = nullptr;
+  try {
+#ifdef __linux__
+    if (UseMmap(bytes, policy))
+      data = static_cast<double*>(MapBuffer(footprint, policy));
+#endif
+    if (data == nullptr) data = new double[bytes / sizeof(double)];
+    Touch(data, rows, cols, policy);
+  } catch (...) {
+    // Буфер и зарезервированный объём возвращаются, если не удалось
+    // выделить или обнулить память
+    if (data != nullptr) ReleaseBuffer(data, bytes, policy);
+    live_bytes.fetch_sub(footprint);
+    throw;
+  }
+
+  allocations.fetch_add(1);
+  {
+    std::lock_guard<std::mutex> lock(operations_mutex);
+    S21OperationMemory& operation = operations[current_operation];
+    ++operation.allocations;
+    operation.bytes += footprint;
+  }
+  Notify(true, footprint, live_bytes.load());
+  return data;
+}
+
+/// @brief Освобождает буфер, выделенный Allocate с теми же параметрами
+void S21Allocator::Free(double* data, std::int64_t rows, std::int64_t cols,
+                        const S21AllocPolicy& policy) noexcept {
+  if (data == nullptr) return;
+  std::size_t footprint = Footprint(rows, cols, policy);
+  std::size_t live = live_bytes.fetch_sub(footprint) - footprint;
+  deallocations.fetch_add(1);
+  Notify(false, footprint, live);
+  ReleaseBuffer(data, Bytes(rows, cols), policy);
+}
+
+/// @brief Политика, с которой создаются новые матрицы
+void S21Allocator::SetDefaultPolicy(const S21AllocPolicy& policy) {
+  std::lock_guard<std::mutex> lock(default_policy_mutex);
+  default_policy = policy;
+}
+
+S21AllocPolicy S21Allocator::GetDefaultPolicy() {
+  std::lock_guard<std::mutex> lock(default_policy_mutex);
+  return default_policy;
+}
+
+/// @brief Размер буфера, начиная с которого он обнуляется потоками пула
+void S21Allocator::SetParallelTouchBytes(std::size_t bytes) noexcept {
+  parallel_touch_bytes = bytes;
+}
+
+std::size_t S21Allocator::GetParallelTouchBytes() noexcept {
+  return parallel_touch_bytes;
+}
+
+/// @brief Текущая статистика буферов матриц
+S21MemoryStats S21Allocator::GetStats() noexcept {
+  S21MemoryStats stats;
+  stats.live_bytes = live_bytes.load();
+  stats.peak_bytes = peak_bytes.load();
+  stats.allocations = allocations.load();
+  stats.deallocations = deallocations.load();
+  return stats;
+}
+
+/// @brief Число и объём выделений по операциям (см. S21MemoryScope),
+/// выделения вне операций собраны под именем "other"
+std::map<std::string, S21OperationMemory> S21Allocator::GetOperationStats() {
+  std::lock_guard<std::mutex> lock(operations_mutex);
+  return operations;
+}
+
+/// @brief Начинает отсчёт пика заново с текущего объёма
+void S21Allocator::ResetPeak() noexcept { peak_bytes = live_bytes.load(); }
+
+/// @brief Жёсткий лимит на суммарный объём буферов матриц: выделение сверх
+/// него бросает S21MemoryLimitExceeded
+/// @param bytes лимит в байтах, 0 - без лимита
+void S21Allocator::SetMemoryLimit(std::size_t bytes) noexcept {
+  memory_limit = bytes;
+}
+
+std::size_t S21Allocator::GetMemoryLimit() noexcept {
+  return memory_limit.load();
+}
+
+/// @brief Регистрирует обработчик, который вызывается при каждом выделении и
+/// освобождении буфера. Обработчики не должны создавать матрицы
+/// @return номер обработчика для RemoveHook
+int S21Allocator::AddHook(S21AllocHook hook) {
+  std::lock_guard<std::mutex> lock(hooks_mutex);
+  hooks.emplace_back(next_hook_id, std::move(hook));
+  has_hooks = true;
+  return next_hook_id++;
+}
+
+void S21Allocator::RemoveHook(int id) {
+  std::lock_guard<std::mutex> lock(hooks_mutex);
+  auto same_id = [id](const auto& hook) { return hook.first == id; };
+  hooks.erase(std::remove_if(hooks.begin(), hooks.end(), same_id),
+              hooks.end());
+  has_hooks = !hooks.empty();
+}
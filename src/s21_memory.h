@@ -0,0 +1,104 @@
+#ifndef S21_MEMORY
+#define S21_MEMORY
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <new>
+#include <string>
+
+/// @brief Использование больших страниц: прозрачные (madvise) или явные
+/// (MAP_HUGETLB, при их нехватке - прозрачные)
+enum class S21HugePages { kNone, kTransparent, kExplicit };
+
+/// @brief Размещение страниц по узлам NUMA: локально для потока, который
+/// первым коснулся страницы, или чередованием по всем узлам
+enum class S21NumaPolicy { kDefault, kLocal, kInterleave };
+
+/// @brief Политика выделения памяти под элементы матрицы
+struct S21AllocPolicy {
+  S21HugePages huge_pages = S21HugePages::kNone;
+  S21NumaPolicy numa = S21NumaPolicy::kDefault;
+  bool parallel_first_touch = true;  // обнулять большой буфер потоками пула
+};
+
+/// @brief Исключение при превышении лимита памяти под буферы матриц.
+/// Наследует std::bad_alloc, поэтому ловится и общими обработчиками
+class S21MemoryLimitExceeded : public std::bad_alloc {
+ public:
+  S21MemoryLimitExceeded(std::size_t requested, std::size_t limit) noexcept;
+  const char* what() const noexcept override;
+  std::size_t GetRequested() const noexcept;
+  std::size_t GetLimit() const noexcept;
+
+ private:
+  std::size_t requested_, limit_;
+};
+
+/// @brief Общая статистика буферов матриц в процессе
+struct S21MemoryStats {
+  std::size_t live_bytes = 0;  // занято сейчас
+  std::size_t peak_bytes = 0;  // максимум с запуска или ResetPeak()
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+};
+
+/// @brief Статистика выделений одной операции (см. S21MemoryScope)
+struct S21OperationMemory {
+  std::size_t allocations = 0;
+  std::size_t bytes = 0;
+};
+
+/// @brief Событие для пользовательских обработчиков выделений
+struct S21AllocEvent {
+  bool allocated;         // true - выделение, false - освобождение
+  std::size_t bytes;      // размер буфера
+  const char* operation;  // операция, в которой произошло событие
+  std::size_t live_bytes;  // занято после события
+};
+
+using S21AllocHook = std::function<void(const S21AllocEvent&)>;
+
+/// @brief Помечает выделения в своей области видимости именем операции
+/// (на текущем потоке, вложенные области перекрывают внешние). Имя должно
+/// жить всё время работы программы, обычно это строковый литерал
+class S21MemoryScope {
+ public:
+  explicit S21MemoryScope(const char* operation) noexcept;
+  ~S21MemoryScope();
+  S21MemoryScope(const S21MemoryScope&) = delete;
+  S21MemoryScope& operator=(const S21MemoryScope&) = delete;
+
+  static const char* Current() noexcept;
+
+ private:
+  const char* previous_;
+};
+
+/// @brief Выделение и освобождение буферов матриц с учётом политики.
+/// Политики - это подсказки ядру: если система их не поддерживает,
+/// память выделяется обычным образом
+class S21Allocator {
+ public:
+  static double* Allocate(std::int64_t rows, std::int64_t cols,
+                          const S21AllocPolicy& policy);
+  static void Free(double* data, std::int64_t rows, std::int64_t cols,
+                   const S21AllocPolicy& policy) noexcept;
+
+  static void SetDefaultPolicy(const S21AllocPolicy& policy);
+  static S21AllocPolicy GetDefaultPolicy();
+  static void SetParallelTouchBytes(std::size_t bytes) noexcept;
+  static std::size_t GetParallelTouchBytes() noexcept;
+
+  // учёт памяти: учитываются буферы элементов всех матриц
+  static S21MemoryStats GetStats() noexcept;
+  static std::map<std::string, S21OperationMemory> GetOperationStats();
+  static void ResetPeak() noexcept;
+  static void SetMemoryLimit(std::size_t bytes) noexcept;
+  static std::size_t GetMemoryLimit() noexcept;
+  static int AddHook(S21AllocHook hook);
+  static void RemoveHook(int id);
+};
+
+#endif  // S21_MEMORY
@@ -0,0 +1,424 @@
+// Проверка производительности: фиксированная нагрузка на API S21Matrix,
+// медианы сравниваются с сохранённой базой (perf_baseline.json).
+//   ./perf_check perf_baseline.json           сравнить с базой
+//   ./perf_check --update perf_baseline.json  перезаписать базу
+// Если доступен perf_event, дополнительно считаются инструкции и промахи
+// кеша; число инструкций почти не шумит, поэтому при его наличии в базе
+// и в замере регрессия определяется по нему
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Число раундов и замеров в раунде на операцию, минимальная длительность
+// одного замера
+constexpr int kRounds = 3;
+constexpr int kSamples = 5;
+constexpr double kMinSampleSeconds = 0.02;
+// Допуски: по времени - не меньше 15% и не меньше трёх относительных
+// медианных отклонений, по инструкциям - 3%
+constexpr double kTimeTolerance = 0.15;
+constexpr double kNoiseFactor = 3.0;
+constexpr double kInstructionTolerance = 0.03;
+// Сколько раз перемерить операцию, прежде чем признать регрессию
+constexpr int kRetries = 2;
+
+/// @brief Результат замера одной операции (на одну итерацию)
+struct Measurement {
+  double median_ns = 0;
+  double mad_ns = 0;  // медианное абсолютное отклонение
+  double instructions = -1;  // -1, если счётчик недоступен
+  double cache_misses = -1;
+};
+
+double Median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  std::size_t middle = values.size() / 2;
+  return values.size() % 2 ? values[middle]
+                           : (values[middle - 1] + values[middle]) / 2;
+}
+
+/// @brief Аппаратные счётчики perf_event: инструкции и промахи кеша
+class PerfCounters {
+ public:
+  PerfCounters() {
+#ifdef __linux__
+    instructions_ = Open(PERF_COUNT_HW_INSTRUCTIONS, -1);
+    if (instructions_ >= 0)
+      cache_misses_ = Open(PERF_COUNT_HW_CACHE_MISSES, instructions_);
+#endif
+  }
+  ~PerfCounters() {
+#ifdef __linux__
+    if (cache_misses_ >= 0) close(cache_misses_);
+    if (instructions_ >= 0) close(instructions_);
+#endif
+  }
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  bool Available() const { return instructions_ >= 0; }
+
+  void Start() {
+#ifdef __linux__
+    if (!Available()) return;
+    ioctl(instructions_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(instructions_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+  }
+
+  /// @brief Останавливает счёт и возвращает {инструкции, промахи кеша}
+  std::pair<double, double> Stop() {
+    double instructions = -1, misses = -1;
+#ifdef __linux__
+    if (!Available()) return {instructions, misses};
+    ioctl(instructions_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    std::uint64_t value = 0;
+    if (read(instructions_, &value, sizeof(value)) == sizeof(value))
+      instructions = static_cast<double>(value);
+    if (cache_misses_ >= 0 &&
+        read(cache_misses_, &value, sizeof(value)) == sizeof(value))
+      misses = static_cast<double>(value);
+#endif
+    return {instructions, misses};
+  }
+
+ private:
+#ifdef __linux__
+  static int Open(std::uint64_t config, int group) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group < 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = 1;  // считаются и потоки пула, созданные после открытия
+    return static_cast<int>(
+        syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+  }
+#endif
+
+  int instructions_ = -1;
+  int cache_misses_ = -1;
+};
+
+S21Matrix Filled(int rows, int cols) {
+  S21Matrix matrix(rows, cols);
+  for (int i = 0; i < rows; ++i)
+    for (int j = 0; j < cols; ++j)
+      matrix(i, j) = std::sin(i * 0.7 + j * 1.3) + (i == j ? cols : 0);
+  return matrix;
+}
+
+/// @brief Операция нагрузки над квадратными матрицами a и b размера size
+struct Workload {
+  std::string name;
+  int size;
+  std::function<void(S21Matrix&, const S21Matrix&)> run;
+};
+
+std::vector<Workload> MakeWorkloads() {
+  std::vector<Workload> workloads;
+  for (int n : {64, 256}) {
+    std::string size = "/" + std::to_string(n);
+    workloads.push_back({"MulMatrix" + size, n,
+                         [](S21Matrix& a, const S21Matrix& b) {
+                           S21Matrix c(a);
+                           c.MulMatrix(b);
+                         }});
+    workloads.push_back({"InverseMatrix" + size, n,
+                         [](S21Matrix& a, const S21Matrix&) {
+                           a.InverseMatrix();
+                         }});
+    workloads.push_back({"Determinant" + size, n,
+                         [](S21Matrix& a, const S21Matrix&) {
+                           a.Determinant();
+                         }});
+  }
+  for (int n : {256, 1024}) {
+    std::string size = "/" + std::to_string(n);
+    workloads.push_back({"SumMatrix" + size, n,
+                         [](S21Matrix& a, const S21Matrix& b) {
+                           a.SumMatrix(b);
+                         }});
+    workloads.push_back({"MulNumber" + size, n,
+                         [](S21Matrix& a, const S21Matrix&) {
+                           a.MulNumber(1.0);
+                         }});
+    workloads.push_back({"Copy" + size, n,
+                         [](S21Matrix& a, const S21Matrix&) {
+                           S21Matrix copy(a);
+                         }});
+    workloads.push_back({"Transpose" + size, n,
+                         [](S21Matrix& a, const S21Matrix&) {
+                           a.Transpose();
+                         }});
+  }
+  return workloads;
+}
+
+/// @brief Замер операции в несколько раундов. В каждом раунде матрицы
+/// выделяются заново, чтобы в разброс попало и размещение в памяти, а не
+/// только шум внутри одного запуска. Число итераций на замер подбирается
+/// так, чтобы замер длился не меньше kMinSampleSeconds
+Measurement Measure(const Workload& workload, PerfCounters* counters) {
+  using Clock = std::chrono::steady_clock;
+  std::vector<double> times, instructions, misses;
+  for (int round = 0; round < kRounds; ++round) {
+    S21Matrix a = Filled(workload.size, workload.size);
+    S21Matrix b = Filled(workload.size, workload.size);
+    auto operation = [&] { workload.run(a, b); };
+    operation();
+    int iterations = 1;
+    while (true) {
+      auto start = Clock::now();
+      for (int i = 0; i < iterations; ++i) operation();
+      double seconds =
+          std::chrono::duration<double>(Clock::now() - start).count();
+      if (seconds >= kMinSampleSeconds) break;
+      iterations *= 2;
+    }
+
+    for (int sample = 0; sample < kSamples; ++sample) {
+      counters->Start();
+      auto start = Clock::now();
+      for (int i = 0; i < iterations; ++i) operation();
+      auto finish = Clock::now();
+      auto [sample_instructions, sample_misses] = counters->Stop();
+      times.push_back(
+          std::chrono::duration<double, std::nano>(finish - start).count() /
+          iterations);
+      if (sample_instructions >= 0)
+        instructions.push_back(sample_instructions / iterations);
+      if (sample_misses >= 0) misses.push_back(sample_misses / iterations);
+    }
+  }
+
+  Measurement result;
+  result.median_ns = Median(times);
+  std::vector<double> deviations;
+  for (double time : times)
+    deviations.push_back(std::fabs(time - result.median_ns));
+  result.mad_ns = Median(deviations);
+  if (!instructions.empty()) result.instructions = Median(instructions);
+  if (!misses.empty()) result.cache_misses = Median(misses);
+  return result;
+}
+
+/// @brief Минимальный разбор JSON базы: объект "operations" с объектами
+/// числовых полей. Другие конструкции JSON не поддерживаются
+class BaselineParser {
+ public:
+  explicit BaselineParser(std::string text) : text_(std::move(text)) {}
+
+  std::map<std::string, Measurement> Parse() {
+    std::map<std::string, Measurement> result;
+    Expect('{');
+    while (Peek() != '}') {
+      std::string key = String();
+      Expect(':');
+      if (key == "operations") {
+        Expect('{');
+        while (Peek() != '}') {
+          std::string name = String();
+          Expect(':');
+          result[name] = Fields();
+          if (Peek() == ',') ++position_;
+        }
+        Expect('}');
+      } else {
+        String();
+      }
+      if (Peek() == ',') ++position_;
+    }
+    return result;
+  }
+
+ private:
+  Measurement Fields() {
+    Measurement measurement;
+    Expect('{');
+    while (Peek() != '}') {
+      std::string field = String();
+      Expect(':');
+      double value = Number();
+      if (field == "median_ns") measurement.median_ns = value;
+      if (field == "mad_ns") measurement.mad_ns = value;
+      if (field == "instructions") measurement.instructions = value;
+      if (field == "cache_misses") measurement.cache_misses = value;
+      if (Peek() == ',') ++position_;
+    }
+    Expect('}');
+    return measurement;
+  }
+
+  char Peek() {
+    while (position_ < text_.size() && std::isspace(text_[position_]))
+      ++position_;
+    if (position_ == text_.size())
+      throw std::runtime_error("неожиданный конец базы");
+    return text_[position_];
+  }
+
+  void Expect(char c) {
+    if (Peek() != c)
+      throw std::runtime_error(std::string("в базе ожидался символ ") + c);
+    ++position_;
+  }
+
+  std::string String() {
+    Expect('"');
+    std::size_t end = text_.find('"', position_);
+    if (end == std::string::npos)
+      throw std::runtime_error("незакрытая строка в базе");
+    std::string value = text_.substr(position_, end - position_);
+    position_ = end + 1;
+    return value;
+  }
+
+  double Number() {
+    Peek();
+    std::size_t used = 0;
+    double value = std::stod(text_.substr(position_), &used);
+    position_ += used;
+    return value;
+  }
+
+  std::string text_;
+  std::size_t position_ = 0;
+};
+
+void WriteBaseline(const std::string& path,
+                   const std::map<std::string, Measurement>& results) {
+  std::ofstream file(path);
+  file << "{\n  \"operations\": {\n";
+  std::size_t index = 0;
+  for (const auto& [name, m] : results) {
+    file << "    \"" << name << "\": {\"median_ns\": " << m.median_ns
+         << ", \"mad_ns\": " << m.mad_ns
+         << ", \"instructions\": " << m.instructions
+         << ", \"cache_misses\": " << m.cache_misses << "}"
+         << (++index < results.size() ? "," : "") << "\n";
+  }
+  file << "  }\n}\n";
+  if (!file) throw std::runtime_error("не удалось записать " + path);
+}
+
+/// @brief Сравнение с базой. Возвращает true, если операция стала медленнее
+/// с учётом шума
+bool Regressed(const Measurement& base, const Measurement& now,
+               std::string* verdict) {
+  char line[160];
+  if (base.instructions > 0 && now.instructions > 0) {
+    double change = now.instructions / base.instructions - 1;
+    std::snprintf(line, sizeof(line), "instr %+6.1f%% (limit %4.1f%%)",
+                  100 * change, 100 * kInstructionTolerance);
+    *verdict = line;
+    return change > kInstructionTolerance;
+  }
+  double noise = kNoiseFactor * (base.mad_ns / base.median_ns +
+                                 now.mad_ns / now.median_ns);
+  double limit = std::max(kTimeTolerance, noise);
+  double change = now.median_ns / base.median_ns - 1;
+  std::snprintf(line, sizeof(line), "time  %+6.1f%% (limit %4.1f%%)",
+                100 * change, 100 * limit);
+  *verdict = line;
+  return change > limit;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  bool update = argc == 3 && std::string(argv[1]) == "--update";
+  if (argc != 2 && !update) {
+    std::cerr << "usage: " << argv[0] << " [--update] baseline.json\n";
+    return 2;
+  }
+  std::string path = argv[argc - 1];
+
+  PerfCounters counters;
+  std::cout << "perf_event: "
+            << (counters.Available() ? "instructions, cache misses"
+                                     : "unavailable, comparing time")
+            << "\n";
+  std::vector<Workload> workloads = MakeWorkloads();
+  std::map<std::string, Measurement> results;
+  for (const auto& workload : workloads)
+    results[workload.name] = Measure(workload, &counters);
+
+  if (update) {
+    WriteBaseline(path, results);
+    std::cout << "baseline written to " << path << "\n";
+    return 0;
+  }
+
+  std::ifstream file(path);
+  if (!file) {
+    std::cerr << "no baseline " << path << ", run make perf-baseline\n";
+    return 2;
+  }
+  std::stringstream text;
+  text << file.rdbuf();
+  std::map<std::string, Measurement> baseline =
+      BaselineParser(text.str()).Parse();
+
+  int regressions = 0;
+  std::printf("%-20s %12s %12s  %s\n", "operation", "base, us", "now, us",
+              "change");
+  for (const auto& workload : workloads) {
+    const std::string& name = workload.name;
+    Measurement now = results[name];
+    auto base = baseline.find(name);
+    if (base == baseline.end()) {
+      std::printf("%-20s %12s %12.1f  new\n", name.c_str(), "-",
+                  now.median_ns / 1000);
+      continue;
+    }
+    // Подозрение на регрессию перепроверяется: на общих машинах одиночный
+    // всплеск нагрузки не должен валить проверку
+    std::string verdict;
+    bool regressed = Regressed(base->second, now, &verdict);
+    for (int retry = 0; retry < kRetries && regressed; ++retry) {
+      Measurement again = Measure(workload, &counters);
+      if (again.median_ns < now.median_ns) now = again;
+      regressed = Regressed(base->second, now, &verdict);
+    }
+    regressions += regressed;
+    std::printf("%-20s %12.1f %12.1f  %s%s\n", name.c_str(),
+                base->second.median_ns / 1000, now.median_ns / 1000,
+                verdict.c_str(), regressed ? "  REGRESSION" : "");
+  }
+  if (regressions > 0) {
+    std::printf("%d operation(s) regressed\n", regressions);
+    return 1;
+  }
+  std::printf("no regressions\n");
+  return 0;
+}
@@ -0,0 +1,225 @@
+#include "s21_qr.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "s21_kernels.h"
+
+namespace {
+
+// Ширина панели столбцов
+constexpr int kPanel = 32;
+
+/// @brief Копирует векторы отражений панели в плотную матрицу V rows x nb
+/// с явной единичной диагональю и нулями над ней
+void ExtractV(const double* a, std::ptrdiff_t lda, std::int64_t rows, int nb,
+              double* v) {
+  for (std::int64_t i = 0; i < rows; ++i) {
+    for (int j = 0; j < nb; ++j) {
+      v[i * nb + j] = i > j ? a[i * lda + j] : (i == j ? 1.0 : 0.0);
+    }
+  }
+}
+
+/// @brief Разложение панели rows x nb отражениями по одному столбцу
+void FactorPanel(double* a, std::ptrdiff_t lda, std::int64_t rows, int nb,
+                 double* tau) {
+  std::vector<double> w(nb);
+  for (int j = 0; j < nb && j < rows; ++j) {
+    double alpha = a[j * lda + j], norm = 0;
+    for (std::int64_t i = j + 1; i < rows; ++i)
+      norm += a[i * lda + j] * a[i * lda + j];
+    if (norm == 0) {
+      tau[j] = 0;
+      continue;
+    }
+    double beta = -std::copysign(std::sqrt(alpha * alpha + norm), alpha);
+    tau[j] = (beta - alpha) / beta;
+    double scale = 1.0 / (alpha - beta);
+    for (std::int64_t i = j + 1; i < rows; ++i) a[i * lda + j] *= scale;
+    a[j * lda + j] = beta;
+
+    // Остальные столбцы панели: A -= tau * v * (v^T A)
+    std::fill(w.begin(), w.end(), 0.0);
+    for (int c = j + 1; c < nb; ++c) w[c] = a[j * lda + c];
+    for (std::int64_t i = j + 1; i < rows; ++i) {
+      double v_i = a[i * lda + j];
+      for (int c = j + 1; c < nb; ++c) w[c] += v_i * a[i * lda + c];
+    }
+    for (int c = j + 1; c < nb; ++c) a[j * lda + c] -= tau[j] * w[c];
+    for (std::int64_t i = j + 1; i < rows; ++i) {
+      double v_i = tau[j] * a[i * lda + j];
+      for (int c = j + 1; c < nb; ++c) a[i * lda + c] -= v_i * w[c];
+    }
+  }
+}
+
+/// @brief Треугольная T панели: H_1 ... H_nb = I - V T V^T. Скалярные
+/// произведения векторов берутся из G = V^T V, посчитанной одним GEMM
+void BuildT(const double* v, std::int64_t rows, int nb, const double* tau,
+            double* t, int ldt) {
+  std::vector<double> g(nb * nb);
+  s21_kernels::Gemm(nb, nb, rows, 1.0, v, nb, true, v, nb, false, 0.0,
+                    g.data(), nb);
+  for (int i = 0; i < nb; ++i) {
+    for (int j = 0; j < nb; ++j) t[j * ldt + i] = 0;
+    t[i * ldt + i] = tau[i];
+    for (int j = 0; j < i; ++j) {
+      double sum = 0;
+      for (int l = j; l < i; ++l) sum += t[j * ldt + l] * g[l * nb + i];
+      t[j * ldt + i] = -tau[i] * sum;
+    }
+  }
+}
+
+/// @brief C = (I - V T V^T) C или, при transpose, C = (I - V T^T V^T) C
+void ApplyBlock(const double* v, std::int64_t rows, int nb, const double* t,
+                int ldt, bool transpose, double* c, std::ptrdiff_t ldc,
+                std::int64_t cols) {
+  if (cols == 0) return;
+  std::vector<double> w(static_cast<std::size_t>(nb) * cols);
+  s21_kernels::Gemm(nb, cols, rows, 1.0, v, nb, true, c, ldc, false, 0.0,
+                    w.data(), cols);
+  // W = T^T W снизу вверх или W = T W сверху вниз, на месте
+  for (int s = 0; s < nb; ++s) {
+    int i = transpose ? nb - 1 - s : s;
+    double* row = w.data() + i * cols;
+    double diagonal = t[i * ldt + i];
+    for (std::int64_t c0 = 0; c0 < cols; ++c0) row[c0] *= diagonal;
+    int from = transpose ? 0 : i + 1, to = transpose ? i : nb;
+    for (int j = from; j < to; ++j) {
+      double t_ij = transpose ? t[j * ldt + i] : t[i * ldt + j];
+      const double* other = w.data() + j * cols;
+      for (std::int64_t c0 = 0; c0 < cols; ++c0) row[c0] += t_ij * other[c0];
+    }
+  }
+  s21_kernels::Gemm(rows, cols, nb, -1.0, v, nb, false, w.data(), cols, false,
+                    1.0, c, ldc);
+}
+
+}  // namespace
+
+/// @brief Раскладывает матрицу m x n при m >= n
+S21QrFactor::S21QrFactor(const S21Matrix& matrix) : qr_(matrix) {
+  std::int64_t m = matrix.rows_;
+  int n = matrix.GetCols();
+  if (m < n)
+    throw std::length_error("число строк меньше числа столбцов");
+  qr_.CheckMatrix(qr_);
+  qr_.Detach();
+
+  tau_.resize(n);
+  t_.resize(static_cast<std::size_t>(kPanel) * n);
+  std::ptrdiff_t lda = qr_.cols_capacity_;
+  std::vector<double> v;
+  for (int k = 0; k < n; k += kPanel) {
+    int nb = std::min(kPanel, n - k);
+    std::int64_t rows = m - k;
+    double* panel = qr_.Row(k) + k;
+    FactorPanel(panel, lda, rows, nb, tau_.data() + k);
+    v.resize(static_cast<std::size_t>(rows) * nb);
+    ExtractV(panel, lda, rows, nb, v.data());
+    BuildT(v.data(), rows, nb, tau_.data() + k, t_.data() + k, n);
+    ApplyBlock(v.data(), rows, nb, t_.data() + k, n, true, panel + nb, lda,
+               n - k - nb);
+  }
+}
+
+int S21QrFactor::GetRows() const { return qr_.GetRows(); }
+
+int S21QrFactor::GetCols() const noexcept {
+  return static_cast<int>(qr_.cols_);
+}
+
+/// @brief Ранг полный, если диагональ R не содержит пренебрежимо малых
+/// относительно её наибольшего элемента
+bool S21QrFactor::IsFullRank() const noexcept {
+  double max_abs = 0;
+  for (int i = 0; i < GetCols(); ++i)
+    max_abs = std::max(max_abs, std::fabs(qr_.Row(i)[i]));
+  double tolerance =
+      static_cast<double>(qr_.rows_) * std::numeric_limits<double>::epsilon() *
+      max_abs;
+  for (int i = 0; i < GetCols(); ++i)
+    if (std::fabs(qr_.Row(i)[i]) <= tolerance) return false;
+  return true;
+}
+
+/// @brief Тонкая Q размером m x n с ортонормированными столбцами
+S21Matrix S21QrFactor::GetQ() const {
+  S21Matrix q(qr_.rows_, qr_.cols_);
+  for (int i = 0; i < GetCols(); ++i) q.Row(i)[i] = 1;
+  Apply(&q, false);
+  return q;
+}
+
+/// @brief Верхняя треугольная R размером n x n
+S21Matrix S21QrFactor::GetR() const {
+  S21Matrix r(GetCols(), GetCols());
+  for (int i = 0; i < GetCols(); ++i)
+    std::copy(qr_.Row(i) + i, qr_.Row(i) + GetCols(), r.Row(i) + i);
+  return r;
+}
+
+/// @brief Q * b для b размером m x k
+S21Matrix S21QrFactor::ApplyQ(const S21Matrix& b) const {
+  S21Matrix result(b);
+  Apply(&result, false);
+  return result;
+}
+
+/// @brief Q^T * b для b размером m x k
+S21Matrix S21QrFactor::ApplyQt(const S21Matrix& b) const {
+  S21Matrix result(b);
+  Apply(&result, true);
+  return result;
+}
+
+/// @brief Решение задачи наименьших квадратов min ||A x - b||: x = R^-1 Q^T b.
+/// В отличие от нормальных уравнений A^T A x = A^T b число обусловленности
+/// не возводится в квадрат
+/// @param b матрица правых частей m x k
+/// @return решение размером n x k
+S21Matrix S21QrFactor::LeastSquares(const S21Matrix& b) const {
+  if (!IsFullRank())
+    throw std::length_error("столбцы матрицы линейно зависимы");
+  S21Matrix y = ApplyQt(b);
+  int n = GetCols();
+  std::int64_t k = b.cols_;
+  S21Matrix x(n, k);
+  for (int i = n - 1; i >= 0; --i) {
+    double* row = x.Row(i);
+    std::copy(y.Row(i), y.Row(i) + k, row);
+    for (int c = i + 1; c < n; ++c) {
+      double r_ic = qr_.Row(i)[c];
+      const double* solved = x.Row(c);
+      for (int j = 0; j < k; ++j) row[j] -= r_ic * solved[j];
+    }
+    double diagonal = qr_.Row(i)[i];
+    for (int j = 0; j < k; ++j) row[j] /= diagonal;
+  }
+  return x;
+}
+
+/// @brief Применение Q = H_1 ... H_n (панели в обратном порядке) или
+/// Q^T (панели в прямом порядке) к матрице b на месте
+void S21QrFactor::Apply(S21Matrix* b, bool transpose) const {
+  if (b->rows_ != qr_.rows_)
+    throw std::length_error("Разная размерность матриц");
+  b->CheckMatrix(*b);
+  b->Detach();
+
+  std::int64_t m = qr_.rows_;
+  int n = GetCols(), panels = (n + kPanel - 1) / kPanel;
+  std::vector<double> v;
+  for (int p = 0; p < panels; ++p) {
+    int k = (transpose ? p : panels - 1 - p) * kPanel;
+    int nb = std::min(kPanel, n - k);
+    std::int64_t rows = m - k;
+    v.resize(static_cast<std::size_t>(rows) * nb);
+    ExtractV(qr_.Row(k) + k, qr_.cols_capacity_, rows, nb, v.data());
+    ApplyBlock(v.data(), rows, nb, t_.data() + k, n, transpose, b->Row(k),
+               b->cols_capacity_, b->cols_);
+  }
+}
@@ -0,0 +1,33 @@
+#ifndef S21_QR
+#define S21_QR
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+/// @brief QR-разложение отражениями Хаусхолдера: A = Q * R для матрицы
+/// m x n при m >= n. Столбцы обрабатываются панелями, отражения панели
+/// собираются в компактное WY-представление I - V T V^T и применяются к
+/// остальной матрице умножениями матриц (GEMM)
+class S21QrFactor {
+ public:
+  explicit S21QrFactor(const S21Matrix& matrix);
+
+  int GetRows() const;
+  int GetCols() const noexcept;
+  bool IsFullRank() const noexcept;
+  S21Matrix GetQ() const;
+  S21Matrix GetR() const;
+  S21Matrix ApplyQ(const S21Matrix& b) const;
+  S21Matrix ApplyQt(const S21Matrix& b) const;
+  S21Matrix LeastSquares(const S21Matrix& b) const;
+
+ private:
+  void Apply(S21Matrix* b, bool transpose) const;
+
+  S21Matrix qr_;  // R на диагонали и выше, векторы отражений ниже
+  std::vector<double> tau_;  // Коэффициенты отражений H = I - tau v v^T
+  std::vector<double> t_;    // Треугольные T панелей, строка i - t_[i * n]
+};
+
+#endif  // S21_QR
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "s21_kernels.h"
+#include "s21_matrix_oop.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Число независимых сумматоров: разрывает цепочку зависимостей сложений и
+// позволяет компилятору разложить цикл по SIMD-регистрам
+constexpr int kLanes = 4;
+
+/// @brief Позиция экстремума для интерфейса с int-индексами
+int ToIndex(std::int64_t index) {
+  if (index > std::numeric_limits<int>::max())
+    throw std::length_error("индекс не помещается в int");
+  return static_cast<int>(index);
+}
+
+/// @brief Все свёртки строки за один проход
+void ReduceRow(const double* row, std::int64_t cols, std::int64_t i,
+               S21Reduction* result) {
+  double sum[kLanes] = {}, squares[kLanes] = {}, max_abs[kLanes] = {};
+  double low[kLanes], high[kLanes];
+  std::fill(low, low + kLanes, std::numeric_limits<double>::infinity());
+  std::fill(high, high + kLanes, -std::numeric_limits<double>::infinity());
+  std::int64_t j = 0;
+  for (; j + kLanes <= cols; j += kLanes) {
+    for (int l = 0; l < kLanes; ++l) {
+      double value = row[j + l];
+      sum[l] += value;
+      squares[l] += value * value;
+      max_abs[l] = std::max(max_abs[l], std::fabs(value));
+      low[l] = std::min(low[l], value);
+      high[l] = std::max(high[l], value);
+    }
+  }
+  for (; j < cols; ++j) {
+    double value = row[j];
+    sum[0] += value;
+    squares[0] += value * value;
+    max_abs[0] = std::max(max_abs[0], std::fabs(value));
+    low[0] = std::min(low[0], value);
+    high[0] = std::max(high[0], value);
+  }
+  for (int l = 0; l < kLanes; ++l) {
+    result->sum += sum[l];
+    result->sum_squares += squares[l];
+    result->max_abs = std::max(result->max_abs, max_abs[l]);
+  }
+  // Позиции экстремумов ищутся только в строках, где экстремум обновился
+  double row_min = *std::min_element(low, low + kLanes);
+  double row_max = *std::max_element(high, high + kLanes);
+  if (row_min < result->min) {
+    result->min = row_min;
+    result->argmin_row = i;
+    result->argmin_col = std::find(row, row + cols, row_min) - row;
+  }
+  if (row_max > result->max) {
+    result->max = row_max;
+    result->argmax_row = i;
+    result->argmax_col = std::find(row, row + cols, row_max) - row;
+  }
+}
+
+/// @brief Объединение свёрток двух последовательных диапазонов строк. При
+/// равных экстремумах остаётся первый по порядку обхода
+void Combine(const S21Reduction& part, S21Reduction* result) {
+  result->sum += part.sum;
+  result->sum_squares += part.sum_squares;
+  result->max_abs = std::max(result->max_abs, part.max_abs);
+  if (part.min < result->min) {
+    result->min = part.min;
+    result->argmin_row = part.argmin_row;
+    result->argmin_col = part.argmin_col;
+  }
+  if (part.max > result->max) {
+    result->max = part.max;
+    result->argmax_row = part.argmax_row;
+    result->argmax_col = part.argmax_col;
+  }
+}
+
+}  // namespace
+
+/// @brief Свёртка всех элементов за один проход: сумма, сумма квадратов,
+/// наибольший модуль, минимум и максимум с их позициями. Куски строк
+/// сворачиваются независимо (большие матрицы в пуле потоков) и объединяются
+/// по порядку, поэтому результат не зависит от числа потоков
+S21Reduction S21Matrix::Reduce() const {
+  CheckMatrix(*this);
+  std::int64_t chunk = S21ThreadPool::ChunkLength(cols_);
+  std::vector<S21Reduction> partial((rows_ + chunk - 1) / chunk);
+  ForRows(rows_, cols_, [&](std::int64_t from, std::int64_t to) {
+    S21Reduction& part = partial[from / chunk];
+    for (std::int64_t i = from; i < to; ++i) ReduceRow(Row(i), cols_, i, &part);
+  });
+  S21Reduction result = partial[0];
+  for (std::size_t part = 1; part < partial.size(); ++part)
+    Combine(partial[part], &result);
+  return result;
+}
+
+double S21Matrix::Sum() const { return Reduce().sum; }
+
+double S21Matrix::Min() const { return Reduce().min; }
+
+double S21Matrix::Max() const { return Reduce().max; }
+
+/// @brief Позиция {строка, столбец} первого минимального элемента
+std::pair<int, int> S21Matrix::ArgMin() const {
+  S21Reduction reduction = Reduce();
+  return {ToIndex(reduction.argmin_row), ToIndex(reduction.argmin_col)};
+}
+
+/// @brief Позиция {строка, столбец} первого максимального элемента
+std::pair<int, int> S21Matrix::ArgMax() const {
+  S21Reduction reduction = Reduce();
+  return {ToIndex(reduction.argmax_row), ToIndex(reduction.argmax_col)};
+}
+
+/// @brief След квадратной матрицы
+double S21Matrix::Trace() const {
+  if (cols_ != rows_) throw std::length_error("матрица не является квадратной");
+  CheckMatrix(*this);
+  double trace = 0;
+  for (std::int64_t i = 0; i < rows_; ++i) trace += Row(i)[i];
+  return trace;
+}
+
+/// @brief Норма Фробениуса: корень из суммы квадратов элементов
+double S21Matrix::NormFrobenius() const {
+  return std::sqrt(Reduce().sum_squares);
+}
+
+/// @brief Норма 1: наибольшая сумма модулей по столбцам
+double S21Matrix::Norm1() const {
+  CheckMatrix(*this);
+  std::vector<double> sums(cols_);
+  ForColumns(rows_, cols_, [&](std::int64_t from, std::int64_t to) {
+    for (std::int64_t i = 0; i < rows_; ++i) {
+      const double* row = Row(i);
+      for (std::int64_t j = from; j < to; ++j) sums[j] += std::fabs(row[j]);
+    }
+  });
+  return *std::max_element(sums.begin(), sums.end());
+}
+
+/// @brief Бесконечная норма: наибольшая сумма модулей по строкам
+double S21Matrix::NormInf() const {
+  CheckMatrix(*this);
+  std::vector<double> sums(rows_);
+  ForRows(rows_, cols_, [&](std::int64_t from, std::int64_t to) {
+    for (std::int64_t i = from; i < to; ++i)
+      sums[i] = s21_kernels::Asum(cols_, Row(i));
+  });
+  return *std::max_element(sums.begin(), sums.end());
+}
+
+/// @brief Суммы строк в столбце размером rows x 1
+S21Matrix S21Matrix::RowSums() const {
+  CheckMatrix(*this);
+  S21Matrix result(rows_, 1);
+  ForRows(rows_, cols_, [&](std::int64_t from, std::int64_t to) {
+    for (std::int64_t i = from; i < to; ++i)
+      result.Row(i)[0] = s21_kernels::Sum(cols_, Row(i));
+  });
+  return result;
+}
+
+/// @brief Суммы столбцов в строке размером 1 x cols. Куски делят столбцы,
+/// поэтому каждый проходит по строкам непрерывными отрезками
+S21Matrix S21Matrix::ColSums() const {
+  CheckMatrix(*this);
+  S21Matrix result(1, cols_);
+  double* sums = result.Row(0);
+  ForColumns(rows_, cols_, [&](std::int64_t from, std::int64_t to) {
+    for (std::int64_t i = 0; i < rows_; ++i) {
+      const double* row = Row(i);
+      for (std::int64_t j = from; j < to; ++j) sums[j] += row[j];
+    }
+  });
+  return result;
+}
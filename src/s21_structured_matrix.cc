@@ -0,0 +1,437 @@
+#include "s21_structured_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include "s21_lu.h"
+
+namespace {
+
+/// @brief Число элементов треугольника матрицы размера n
+std::size_t PackedSize(std::size_t n) { return n * (n + 1) / 2; }
+
+/// @brief Длина упакованного треугольника матрицы размера n. Размеры, для
+/// которых она не помещается в std::vector, отклоняются
+std::size_t CheckedPackedSize(int n) {
+  if (n < 0)
+    throw std::length_error("число строк не может быть отрицательным");
+  std::size_t size = PackedSize(n);
+  if (size > std::vector<double>().max_size())
+    throw std::length_error("размер матрицы слишком велик");
+  return size;
+}
+
+/// @brief Разложение Холецкого A = L * L^T для упакованной симметричной
+/// матрицы (нижний треугольник построчно)
+/// @return false, если матрица не положительно определена
+bool Cholesky(const std::vector<double>& a, int n, std::vector<double>* l) {
+  l->assign(a.size(), 0.0);
+  for (int i = 0; i < n; ++i) {
+    double* l_row = l->data() + PackedSize(i);
+    for (int j = 0; j <= i; ++j) {
+      const double* l_col = l->data() + PackedSize(j);
+      double sum = a[PackedSize(i) + j];
+      for (int k = 0; k < j; ++k) sum -= l_row[k] * l_col[k];
+      if (i == j) {
+        if (sum <= 0) return false;
+        l_row[j] = std::sqrt(sum);
+      } else {
+        l_row[j] = sum / l_col[j];
+      }
+    }
+  }
+  return true;
+}
+
+/// @brief Номер элемента (i, j) ленты в массиве: строка хранит kl + ku + 1
+/// элементов, начиная с диагонали -kl
+std::size_t BandIndex(int i, int j, int kl, int ku) {
+  std::size_t width = static_cast<std::size_t>(kl) + ku + 1;
+  return static_cast<std::size_t>(i) * width + j - i + kl;
+}
+
+/// @brief LU-разложение ленточной матрицы с частичным выбором ведущего
+/// элемента. Из-за перестановок лента U расширяется до kl + ku наддиагоналей,
+/// поэтому строка рабочего массива хранит 2 * kl + ku + 1 элементов
+struct BandLu {
+  BandLu(const std::vector<double>& band, int n, int kl, int ku)
+      : n(n),
+        kl(kl),
+        width(2 * static_cast<std::size_t>(kl) + ku + 1),
+        w(static_cast<std::size_t>(n) * width),
+        pivots(n),
+        sign(1) {
+    for (int i = 0; i < n; ++i)
+      for (int j = std::max(0, i - kl); j <= std::min(n - 1, i + ku); ++j)
+        At(i, j) = band[BandIndex(i, j, kl, ku)];
+
+    for (int c = 0; c < n; ++c) {
+      int last_row = std::min(n - 1, c + kl);
+      int last_col = std::min(n - 1, c + kl + ku);
+      int pivot = c;
+      for (int r = c + 1; r <= last_row; ++r)
+        if (std::fabs(At(r, c)) > std::fabs(At(pivot, c))) pivot = r;
+      pivots[c] = pivot;
+      if (pivot != c) {
+        sign = -sign;
+        for (int j = c; j <= last_col; ++j) std::swap(At(c, j), At(pivot, j));
+      }
+      if (At(c, c) == 0.0) continue;
+      for (int r = c + 1; r <= last_row; ++r) {
+        double multiplier = At(r, c) / At(c, c);
+        At(r, c) = multiplier;
+        for (int j = c + 1; j <= last_col; ++j)
+          At(r, j) -= multiplier * At(c, j);
+      }
+    }
+  }
+
+  double& At(int i, int j) {
+    return w[static_cast<std::size_t>(i) * width + j - i + kl];
+  }
+
+  double Determinant() {
+    double result = sign;
+    for (int i = 0; i < n; ++i) result *= At(i, i);
+    return result;
+  }
+
+  int n, kl;
+  std::size_t width;
+  std::vector<double> w;
+  std::vector<int> pivots;
+  int sign;
+};
+
+}  // namespace
+
+// Треугольная матрица
+
+S21TriangularMatrix::S21TriangularMatrix(int size, S21Triangle triangle)
+    : size_(size), triangle_(triangle) {
+  data_.assign(CheckedPackedSize(size), 0.0);
+}
+
+/// @brief Упаковывает треугольник квадратной матрицы, остальные элементы
+/// отбрасываются
+S21TriangularMatrix::S21TriangularMatrix(const S21Matrix& matrix,
+                                         S21Triangle triangle)
+    : S21TriangularMatrix(matrix.GetRows(), triangle) {
+  if (matrix.GetRows() != matrix.GetCols())
+    throw std::length_error("матрица не является квадратной");
+  for (int i = 0; i < size_; ++i)
+    for (int j = 0; j < size_; ++j)
+      if (InTriangle(i, j)) data_[Index(i, j)] = matrix.Row(i)[j];
+}
+
+int S21TriangularMatrix::GetSize() const noexcept { return size_; }
+
+S21Triangle S21TriangularMatrix::GetTriangle() const noexcept {
+  return triangle_;
+}
+
+/// @brief Элемент вне треугольника равен нулю
+double S21TriangularMatrix::operator()(int i, int j) const {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_)
+    throw std::length_error("индекс за пределами матрицы");
+  return InTriangle(i, j) ? data_[Index(i, j)] : 0.0;
+}
+
+/// @brief Изменять можно только элементы треугольника
+double& S21TriangularMatrix::operator()(int i, int j) {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_ || !InTriangle(i, j))
+    throw std::length_error("индекс за пределами матрицы");
+  return data_[Index(i, j)];
+}
+
+S21Matrix S21TriangularMatrix::ToMatrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; ++i)
+    for (int j = 0; j < size_; ++j)
+      if (InTriangle(i, j)) result.Row(i)[j] = data_[Index(i, j)];
+  return result;
+}
+
+/// @brief Определитель треугольной матрицы - произведение диагонали
+double S21TriangularMatrix::Determinant() const noexcept {
+  double result = 1;
+  for (int i = 0; i < size_; ++i) result *= data_[Index(i, i)];
+  return result;
+}
+
+/// @brief Произведение this * other, проходит только по треугольнику
+S21Matrix S21TriangularMatrix::Mul(const S21Matrix& other) const {
+  if (other.rows_ != size_)
+    throw std::length_error(
+        "число столбцов первой матрицы не равно числу строк второй матрицы");
+  other.CheckMatrix(other);
+
+  S21Matrix result(size_, other.cols_);
+  for (int i = 0; i < size_; ++i) {
+    int first = triangle_ == S21Triangle::kLower ? 0 : i;
+    int last = triangle_ == S21Triangle::kLower ? i : size_ - 1;
+    double* row = result.Row(i);
+    for (int k = first; k <= last; ++k) {
+      double a_ik = data_[Index(i, k)];
+      const double* other_row = other.Row(k);
+      for (int j = 0; j < other.cols_; ++j) row[j] += a_ik * other_row[j];
+    }
+  }
+  return result;
+}
+
+/// @brief Решение this * x = b прямой (для нижней) или обратной (для
+/// верхней) подстановкой за O(n^2) на каждый столбец b
+S21Matrix S21TriangularMatrix::Solve(const S21Matrix& b) const {
+  if (b.rows_ != size_) throw std::length_error("Разная размерность матриц");
+  b.CheckMatrix(b);
+  for (int i = 0; i < size_; ++i)
+    if (data_[Index(i, i)] == 0.0)
+      throw std::length_error("определитель матрицы равен 0");
+
+  S21Matrix x(b);
+  x.Detach();
+  bool lower = triangle_ == S21Triangle::kLower;
+  for (int step = 0; step < size_; ++step) {
+    int i = lower ? step : size_ - 1 - step;
+    double* row = x.Row(i);
+    int first = lower ? 0 : i + 1;
+    int last = lower ? i - 1 : size_ - 1;
+    for (int k = first; k <= last; ++k) {
+      double a_ik = data_[Index(i, k)];
+      const double* solved = x.Row(k);
+      for (int j = 0; j < x.cols_; ++j) row[j] -= a_ik * solved[j];
+    }
+    double diagonal = data_[Index(i, i)];
+    for (int j = 0; j < x.cols_; ++j) row[j] /= diagonal;
+  }
+  return x;
+}
+
+bool S21TriangularMatrix::InTriangle(int i, int j) const noexcept {
+  return triangle_ == S21Triangle::kLower ? j <= i : j >= i;
+}
+
+/// @brief Номер элемента треугольника в упакованном массиве. Нижний
+/// треугольник: строка i занимает i + 1 элементов, верхний: n - i элементов
+std::size_t S21TriangularMatrix::Index(int i, int j) const noexcept {
+  if (triangle_ == S21Triangle::kLower) return PackedSize(i) + j;
+  std::size_t row = i;
+  return row * size_ - PackedSize(row) + j;
+}
+
+// Симметричная матрица
+
+S21SymmetricMatrix::S21SymmetricMatrix(int size) : size_(size) {
+  data_.assign(CheckedPackedSize(size), 0.0);
+}
+
+/// @brief Упаковывает нижний треугольник квадратной матрицы
+S21SymmetricMatrix::S21SymmetricMatrix(const S21Matrix& matrix)
+    : S21SymmetricMatrix(matrix.GetRows()) {
+  if (matrix.GetRows() != matrix.GetCols())
+    throw std::length_error("матрица не является квадратной");
+  for (int i = 0; i < size_; ++i)
+    for (int j = 0; j <= i; ++j) data_[PackedSize(i) + j] = matrix.Row(i)[j];
+}
+
+int S21SymmetricMatrix::GetSize() const noexcept { return size_; }
+
+double S21SymmetricMatrix::operator()(int i, int j) const {
+  return data_[Index(i, j)];
+}
+
+/// @brief Ссылка на элемент (i, j), он же элемент (j, i)
+double& S21SymmetricMatrix::operator()(int i, int j) {
+  return data_[Index(i, j)];
+}
+
+S21Matrix S21SymmetricMatrix::ToMatrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; ++i) {
+    for (int j = 0; j <= i; ++j) {
+      result.Row(i)[j] = data_[PackedSize(i) + j];
+      result.Row(j)[i] = data_[PackedSize(i) + j];
+    }
+  }
+  return result;
+}
+
+/// @brief Определитель через разложение Холецкого, если матрица положительно
+/// определена, иначе через LU полной матрицы
+double S21SymmetricMatrix::Determinant() const {
+  if (size_ == 0) throw std::length_error("матрица пустая");
+  std::vector<double> l;
+  if (!Cholesky(data_, size_, &l)) return S21LuFactor(ToMatrix()).Determinant();
+  double result = 1;
+  for (int i = 0; i < size_; ++i) result *= l[PackedSize(i) + i];
+  return result * result;
+}
+
+/// @brief Произведение this * other. Каждый элемент упакованного
+/// треугольника читается один раз и используется для двух строк результата
+S21Matrix S21SymmetricMatrix::Mul(const S21Matrix& other) const {
+  if (other.rows_ != size_)
+    throw std::length_error(
+        "число столбцов первой матрицы не равно числу строк второй матрицы");
+  other.CheckMatrix(other);
+
+  S21Matrix result(size_, other.cols_);
+  for (int i = 0; i < size_; ++i) {
+    double* row_i = result.Row(i);
+    const double* other_i = other.Row(i);
+    for (int k = 0; k <= i; ++k) {
+      double a_ik = data_[PackedSize(i) + k];
+      const double* other_k = other.Row(k);
+      for (int j = 0; j < other.cols_; ++j) row_i[j] += a_ik * other_k[j];
+      if (k != i) {
+        double* row_k = result.Row(k);
+        for (int j = 0; j < other.cols_; ++j) row_k[j] += a_ik * other_i[j];
+      }
+    }
+  }
+  return result;
+}
+
+/// @brief Решение this * x = b: для положительно определённой матрицы через
+/// разложение Холецкого (две треугольные подстановки), иначе через LU
+S21Matrix S21SymmetricMatrix::Solve(const S21Matrix& b) const {
+  if (b.rows_ != size_) throw std::length_error("Разная размерность матриц");
+  std::vector<double> l;
+  if (!Cholesky(data_, size_, &l)) return S21LuFactor(ToMatrix()).Solve(b);
+
+  S21TriangularMatrix lower(size_, S21Triangle::kLower);
+  S21TriangularMatrix upper(size_, S21Triangle::kUpper);
+  for (int i = 0; i < size_; ++i) {
+    for (int j = 0; j <= i; ++j) {
+      lower(i, j) = l[PackedSize(i) + j];
+      upper(j, i) = l[PackedSize(i) + j];
+    }
+  }
+  return upper.Solve(lower.Solve(b));
+}
+
+std::size_t S21SymmetricMatrix::Index(int i, int j) const {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_)
+    throw std::length_error("индекс за пределами матрицы");
+  return i >= j ? PackedSize(i) + j : PackedSize(j) + i;
+}
+
+// Ленточная матрица
+
+S21BandMatrix::S21BandMatrix(int size, int kl, int ku)
+    : size_(size), kl_(kl), ku_(ku) {
+  if (size < 0 || kl < 0 || ku < 0)
+    throw std::length_error(
+        "число столбцов и строк не может быть отрицательным");
+  // Индексы ленты считаются в int, и самый дальний из них, i + kl + ku в
+  // LU-разложении, вместе со строкой рабочего массива длины 2 * kl + ku + 1
+  // должен в нём помещаться
+  std::int64_t lu_width = 2 * static_cast<std::int64_t>(kl) + ku + 1;
+  std::size_t width = static_cast<std::size_t>(kl) + ku + 1;
+  if (size + lu_width > std::numeric_limits<int>::max() ||
+      static_cast<std::size_t>(lu_width) >
+          std::vector<double>().max_size() / std::max(size, 1))
+    throw std::length_error("размер матрицы слишком велик");
+  data_.assign(static_cast<std::size_t>(size) * width, 0.0);
+}
+
+/// @brief Переносит ленту квадратной матрицы, элементы вне ленты
+/// отбрасываются
+S21BandMatrix::S21BandMatrix(const S21Matrix& matrix, int kl, int ku)
+    : S21BandMatrix(matrix.GetRows(), kl, ku) {
+  if (matrix.GetRows() != matrix.GetCols())
+    throw std::length_error("матрица не является квадратной");
+  for (int i = 0; i < size_; ++i)
+    for (int j = std::max(0, i - kl_); j <= std::min(size_ - 1, i + ku_); ++j)
+      (*this)(i, j) = matrix.Row(i)[j];
+}
+
+int S21BandMatrix::GetSize() const noexcept { return size_; }
+int S21BandMatrix::GetLower() const noexcept { return kl_; }
+int S21BandMatrix::GetUpper() const noexcept { return ku_; }
+
+/// @brief Элемент вне ленты равен нулю
+double S21BandMatrix::operator()(int i, int j) const {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_)
+    throw std::length_error("индекс за пределами матрицы");
+  return InBand(i, j) ? data_[BandIndex(i, j, kl_, ku_)] : 0.0;
+}
+
+/// @brief Изменять можно только элементы ленты
+double& S21BandMatrix::operator()(int i, int j) {
+  if (i < 0 || i >= size_ || j < 0 || j >= size_ || !InBand(i, j))
+    throw std::length_error("индекс за пределами матрицы");
+  return data_[BandIndex(i, j, kl_, ku_)];
+}
+
+S21Matrix S21BandMatrix::ToMatrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; ++i)
+    for (int j = std::max(0, i - kl_); j <= std::min(size_ - 1, i + ku_); ++j)
+      result.Row(i)[j] = (*this)(i, j);
+  return result;
+}
+
+/// @brief Определитель через ленточное LU-разложение за O(n * kl * (kl + ku))
+double S21BandMatrix::Determinant() const {
+  if (size_ == 0) throw std::length_error("матрица пустая");
+  return BandLu(data_, size_, kl_, ku_).Determinant();
+}
+
+/// @brief Произведение this * other, проходит только по ленте
+S21Matrix S21BandMatrix::Mul(const S21Matrix& other) const {
+  if (other.rows_ != size_)
+    throw std::length_error(
+        "число столбцов первой матрицы не равно числу строк второй матрицы");
+  other.CheckMatrix(other);
+
+  S21Matrix result(size_, other.cols_);
+  for (int i = 0; i < size_; ++i) {
+    double* row = result.Row(i);
+    for (int k = std::max(0, i - kl_); k <= std::min(size_ - 1, i + ku_); ++k) {
+      double a_ik = data_[BandIndex(i, k, kl_, ku_)];
+      const double* other_row = other.Row(k);
+      for (int j = 0; j < other.cols_; ++j) row[j] += a_ik * other_row[j];
+    }
+  }
+  return result;
+}
+
+/// @brief Решение this * x = b через ленточное LU-разложение
+S21Matrix S21BandMatrix::Solve(const S21Matrix& b) const {
+  if (b.rows_ != size_) throw std::length_error("Разная размерность матриц");
+  b.CheckMatrix(b);
+  BandLu lu(data_, size_, kl_, ku_);
+  for (int i = 0; i < size_; ++i)
+    if (lu.At(i, i) == 0.0)
+      throw std::length_error("определитель матрицы равен 0");
+
+  S21Matrix x(b);
+  x.Detach();
+  int upper = kl_ + ku_;
+  for (int c = 0; c < size_; ++c) {
+    if (lu.pivots[c] != c)
+      std::swap_ranges(x.Row(c), x.Row(c) + x.cols_, x.Row(lu.pivots[c]));
+    for (int r = c + 1; r <= std::min(size_ - 1, c + kl_); ++r) {
+      double l_rc = lu.At(r, c);
+      for (int j = 0; j < x.cols_; ++j) x.Row(r)[j] -= l_rc * x.Row(c)[j];
+    }
+  }
+  for (int i = size_ - 1; i >= 0; --i) {
+    for (int k = i + 1; k <= std::min(size_ - 1, i + upper); ++k) {
+      double u_ik = lu.At(i, k);
+      for (int j = 0; j < x.cols_; ++j) x.Row(i)[j] -= u_ik * x.Row(k)[j];
+    }
+    double diagonal = lu.At(i, i);
+    for (int j = 0; j < x.cols_; ++j) x.Row(i)[j] /= diagonal;
+  }
+  return x;
+}
+
+bool S21BandMatrix::InBand(int i, int j) const noexcept {
+  return j >= i - kl_ && j <= i + ku_;
+}
@@ -0,0 +1,85 @@
+#ifndef S21_STRUCTURED_MATRIX
+#define S21_STRUCTURED_MATRIX
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+/// @brief Какой треугольник хранит треугольная матрица
+enum class S21Triangle { kLower, kUpper };
+
+/// @brief Квадратная треугольная матрица в упакованном виде: хранится только
+/// n * (n + 1) / 2 элементов треугольника, построчно
+class S21TriangularMatrix {
+ public:
+  S21TriangularMatrix(int size, S21Triangle triangle);
+  S21TriangularMatrix(const S21Matrix& matrix, S21Triangle triangle);
+
+  int GetSize() const noexcept;
+  S21Triangle GetTriangle() const noexcept;
+  double operator()(int i, int j) const;
+  double& operator()(int i, int j);
+
+  S21Matrix ToMatrix() const;
+  double Determinant() const noexcept;
+  S21Matrix Mul(const S21Matrix& other) const;
+  S21Matrix Solve(const S21Matrix& b) const;
+
+ private:
+  bool InTriangle(int i, int j) const noexcept;
+  std::size_t Index(int i, int j) const noexcept;
+
+  int size_;
+  S21Triangle triangle_;
+  std::vector<double> data_;
+};
+
+/// @brief Симметричная матрица в упакованном виде: хранится нижний
+/// треугольник, элемент (i, j) совпадает с (j, i)
+class S21SymmetricMatrix {
+ public:
+  explicit S21SymmetricMatrix(int size);
+  explicit S21SymmetricMatrix(const S21Matrix& matrix);
+
+  int GetSize() const noexcept;
+  double operator()(int i, int j) const;
+  double& operator()(int i, int j);
+
+  S21Matrix ToMatrix() const;
+  double Determinant() const;
+  S21Matrix Mul(const S21Matrix& other) const;
+  S21Matrix Solve(const S21Matrix& b) const;
+
+ private:
+  std::size_t Index(int i, int j) const;
+
+  int size_;
+  std::vector<double> data_;
+};
+
+/// @brief Ленточная матрица с kl поддиагоналями и ku наддиагоналями.
+/// Каждая строка хранит kl + ku + 1 элементов ленты
+class S21BandMatrix {
+ public:
+  S21BandMatrix(int size, int kl, int ku);
+  S21BandMatrix(const S21Matrix& matrix, int kl, int ku);
+
+  int GetSize() const noexcept;
+  int GetLower() const noexcept;
+  int GetUpper() const noexcept;
+  double operator()(int i, int j) const;
+  double& operator()(int i, int j);
+
+  S21Matrix ToMatrix() const;
+  double Determinant() const;
+  S21Matrix Mul(const S21Matrix& other) const;
+  S21Matrix Solve(const S21Matrix& b) const;
+
+ private:
+  bool InBand(int i, int j) const noexcept;
+
+  int size_, kl_, ku_;
+  std::vector<double> data_;
+};
+
+#endif  // S21_STRUCTURED_MATRIX
@@ -0,0 +1,269 @@
+#include "s21_thread_pool.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// Номер очереди текущего потока, если он является рабочим потоком пула
+thread_local const S21ThreadPool* tls_pool = nullptr;
+thread_local int tls_index = -1;
+
+/// @brief Число рабочих потоков по умолчанию. Переменная окружения
+/// S21_NUM_THREADS задаёт его явно
+int DefaultThreads() {
+  const char* env = std::getenv("S21_NUM_THREADS");
+  if (env != nullptr && std::atoi(env) > 0) return std::atoi(env);
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+}
+
+}  // namespace
+
+S21ThreadPool::S21ThreadPool(int threads)
+    : sleeping_(0),
+      pending_(0),
+      next_queue_(0),
+      stop_(false),
+      owner_(getpid()) {
+  threads = std::max(1, threads);
+  for (int i = 0; i < threads; ++i)
+    queues_.push_back(std::make_unique<Queue>());
+  for (int i = 0; i < threads; ++i)
+    workers_.emplace_back(&S21ThreadPool::WorkerLoop, this, i);
+}
+
+/// @brief Деструктор дожидается выполнения всех поставленных задач
+S21ThreadPool::~S21ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& worker : workers_) worker.join();
+}
+
+/// @brief Общий пул библиотеки
+S21ThreadPool& S21ThreadPool::Instance() {
+  static S21ThreadPool pool(DefaultThreads());
+  return pool;
+}
+
+int S21ThreadPool::Size() const noexcept {
+  return static_cast<int>(queues_.size());
+}
+
+/// @brief Ставит задачу в очередь. Задача, поставленная из рабочего потока,
+/// попадает в его собственную очередь. Исключения из задачи не перехватываются.
+/// В процессе, порождённом fork(), рабочих потоков нет, и задача выполняется
+/// сразу в вызывающем потоке
+void S21ThreadPool::Submit(std::function<void()> task) {
+  if (getpid() != owner_) {
+    task();
+    return;
+  }
+  int index = tls_pool == this ? tls_index
+                               : static_cast<int>(next_queue_++ % Size());
+  {
+    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+    queues_[index]->tasks.push_back(std::move(task));
+  }
+  ++pending_;
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+  }
+  wake_.notify_one();
+}
+
+/// @brief Выполняется ли вызов в рабочем потоке этого пула
+bool S21ThreadPool::IsWorkerThread() const noexcept { return tls_pool == this; }
+
+/// @brief Число рабочих потоков пула в текущем процессе: в порождённом
+/// fork() процессе их нет
+int S21ThreadPool::LiveWorkers() const noexcept {
+  return getpid() == owner_ ? static_cast<int>(workers_.size()) : 0;
+}
+
+/// @brief Дожидается, пока все рабочие потоки уснут без задач, и не даёт им
+/// проснуться, пока жива возвращённая блокировка. В это время рабочие потоки
+/// не держат ни одной блокировки, и процесс можно порождать fork(). Задачи,
+/// поставленные другими потоками, откладывают возврат, поэтому вызывать из
+/// рабочего потока нельзя
+std::unique_lock<std::mutex> S21ThreadPool::Quiesce() {
+  if (LiveWorkers() == 0) return std::unique_lock<std::mutex>();
+  std::unique_lock<std::mutex> lock(sleep_mutex_);
+  idle_.wait(lock, [this] { return sleeping_ == Size() && pending_ == 0; });
+  return lock;
+}
+
+/// @brief Выполняет одну задачу из очередей пула в текущем потоке. Нужен
+/// ожидающим потокам, чтобы они помогали пулу, а не простаивали
+/// @return false, если задач нет
+bool S21ThreadPool::RunPendingTask() {
+  std::function<void()> task;
+  if (!PopTask(tls_pool == this ? tls_index : -1, &task)) return false;
+  task();
+  return true;
+}
+
+/// @brief Статическое разбиение диапазона [begin, end) на Size() + 1
+/// одинаковых частей, одна из которых выполняется в вызывающем потоке.
+/// Границы частей зависят от размера пула; для результатов, которые не должны
+/// от него зависеть, есть ParallelChunks
+void S21ThreadPool::ParallelFor(int begin, int end,
+                                const std::function<void(int, int)>& body) {
+  int length = end - begin;
+  int chunks = std::min(Size() + 1, length);
+  if (chunks <= 1) {
+    if (length > 0) body(begin, end);
+    return;
+  }
+  auto bound = [&](int chunk) {
+    return begin + static_cast<int>(static_cast<long long>(length) * chunk /
+                                    chunks);
+  };
+  S21TaskGroup group(*this);
+  for (int chunk = 1; chunk < chunks; ++chunk) {
+    int from = bound(chunk), to = bound(chunk + 1);
+    group.Run([&body, from, to] { body(from, to); });
+  }
+  body(begin, bound(1));
+  group.Wait();
+}
+
+/// @brief Вызывает body(from, to) для каждого куска [from, to) длины chunk
+/// (последний может быть короче) из диапазона [0, count). Куски не зависят от
+/// размера пула, потоки получают непрерывные группы кусков
+void S21ThreadPool::ParallelChunks(
+    std::int64_t count, std::int64_t chunk,
+    const std::function<void(std::int64_t, std::int64_t)>& body) {
+  std::int64_t chunks = (count + chunk - 1) / chunk;
+  int groups = static_cast<int>(std::min<std::int64_t>(chunks, Size() + 1));
+  ParallelFor(0, groups, [&](int from, int to) {
+    for (std::int64_t c = chunks * from / groups; c < chunks * to / groups;
+         ++c)
+      body(c * chunk, std::min(count, (c + 1) * chunk));
+  });
+}
+
+/// @brief Число строк шириной width в куске ParallelChunks: не меньше одной
+/// и около kChunkWork элементов
+std::int64_t S21ThreadPool::ChunkLength(std::int64_t width) noexcept {
+  return std::max<std::int64_t>(1,
+                                kChunkWork / std::max<std::int64_t>(width, 1));
+}
+
+/// @brief Забирает задачу: сначала последнюю из своей очереди, затем первую
+/// из чужих
+/// @param index номер своей очереди или -1 для внешнего потока
+bool S21ThreadPool::PopTask(int index, std::function<void()>* task) {
+  int size = Size();
+  if (index >= 0) {
+    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+    if (!queues_[index]->tasks.empty()) {
+      *task = std::move(queues_[index]->tasks.back());
+      queues_[index]->tasks.pop_back();
+      --pending_;
+      return true;
+    }
+  }
+  for (int shift = 1; shift <= size; ++shift) {
+    int victim = (std::max(index, 0) + shift) % size;
+    std::lock_guard<std::mutex> lock(queues_[victim]->mutex);
+    if (!queues_[victim]->tasks.empty()) {
+      *task = std::move(queues_[victim]->tasks.front());
+      queues_[victim]->tasks.pop_front();
+      --pending_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void S21ThreadPool::WorkerLoop(int index) {
+  tls_pool = this;
+  tls_index = index;
+  std::function<void()> task;
+  while (true) {
+    if (PopTask(index, &task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    if (++sleeping_ == Size()) idle_.notify_all();
+    wake_.wait(lock, [this] { return stop_ || pending_ > 0; });
+    --sleeping_;
+    if (stop_ && pending_ == 0) return;
+  }
+}
+
+S21TaskGroup::S21TaskGroup(S21ThreadPool& pool)
+    : pool_(pool), state_(std::make_shared<State>()) {}
+
+S21TaskGroup::~S21TaskGroup() {
+  try {
+    Wait();
+  } catch (...) {
+  }
+}
+
+/// @brief Запускает задачу в пуле. Исключение задачи сохраняется и
+/// пробрасывается из Wait()
+void S21TaskGroup::Run(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->tasks.push_back(std::move(task));
+    ++state_->active;
+  }
+  state_->changed.notify_all();
+  pool_.Submit([state = state_] { RunOne(*state); });
+}
+
+/// @brief Выполняет одну не начатую задачу группы, если она есть. Задачу
+/// может забрать и поток пула, и ожидающий в Wait()
+void S21TaskGroup::RunOne(State& state) {
+  std::function<void()> task;
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (state.tasks.empty()) return;
+    task = std::move(state.tasks.front());
+    state.tasks.pop_front();
+  }
+  std::exception_ptr error;
+  try {
+    task();
+  } catch (...) {
+    error = std::current_exception();
+  }
+  bool finished;
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (error && !state.error) state.error = error;
+    finished = --state.active == 0;
+  }
+  if (finished) state.changed.notify_all();
+}
+
+/// @brief Ожидание задач группы. Вызывающий поток выполняет не начатые
+/// задачи группы, а затем спит, пока не завершатся выполняемые другими
+/// потоками или не появятся новые
+void S21TaskGroup::Wait() {
+  State& state = *state_;
+  std::unique_lock<std::mutex> lock(state.mutex);
+  while (state.active > 0) {
+    if (state.tasks.empty()) {
+      state.changed.wait(lock);
+      continue;
+    }
+    lock.unlock();
+    RunOne(state);
+    lock.lock();
+  }
+  if (state.error) {
+    std::exception_ptr error = state.error;
+    state.error = nullptr;
+    std::rethrow_exception(error);
+  }
+}
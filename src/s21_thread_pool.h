@@ -0,0 +1,96 @@
+#ifndef S21_THREAD_POOL
+#define S21_THREAD_POOL
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief Пул потоков с воровством задач: у каждого потока своя очередь,
+/// свободный поток забирает задачи из чужих очередей
+class S21ThreadPool {
+ public:
+  explicit S21ThreadPool(int threads);
+  S21ThreadPool(const S21ThreadPool&) = delete;
+  S21ThreadPool& operator=(const S21ThreadPool&) = delete;
+  ~S21ThreadPool();
+
+  static S21ThreadPool& Instance();
+
+  int Size() const noexcept;
+  void Submit(std::function<void()> task);
+  bool RunPendingTask();
+  bool IsWorkerThread() const noexcept;
+  int LiveWorkers() const noexcept;
+  std::unique_lock<std::mutex> Quiesce();
+  void ParallelFor(int begin, int end,
+                   const std::function<void(int, int)>& body);
+  void ParallelChunks(
+      std::int64_t count, std::int64_t chunk,
+      const std::function<void(std::int64_t, std::int64_t)>& body);
+
+  // Примерное число элементов в одном куске ParallelChunks
+  static constexpr std::int64_t kChunkWork = 1 << 13;
+  static std::int64_t ChunkLength(std::int64_t width) noexcept;
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  bool PopTask(int index, std::function<void()>* task);
+  void WorkerLoop(int index);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  std::condition_variable idle_;
+  int sleeping_;  // Уснувшие без задач рабочие потоки, под sleep_mutex_
+  std::atomic<int> pending_;
+  std::atomic<unsigned> next_queue_;
+  bool stop_;
+  pid_t owner_;  // Процесс, в котором запущены рабочие потоки
+};
+
+/// @brief Группа задач пула, Wait() дожидается завершения всех задач группы
+/// (в том числе порождённых изнутри задач) и пробрасывает первое исключение.
+/// Ожидающий поток выполняет только ещё не начатые задачи своей группы, а
+/// когда их нет - спит до завершения остальных
+class S21TaskGroup {
+ public:
+  explicit S21TaskGroup(S21ThreadPool& pool = S21ThreadPool::Instance());
+  S21TaskGroup(const S21TaskGroup&) = delete;
+  S21TaskGroup& operator=(const S21TaskGroup&) = delete;
+  ~S21TaskGroup();
+
+  void Run(std::function<void()> task);
+  void Wait();
+
+ private:
+  // Состояние разделяется с задачами пула: задача пула может начаться уже
+  // после Wait(), когда её работу выполнил ожидающий поток
+  struct State {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::function<void()>> tasks;  // Ещё не начатые задачи
+    int active = 0;                           // Незавершённые задачи
+    std::exception_ptr error;
+  };
+
+  static void RunOne(State& state);
+
+  S21ThreadPool& pool_;
+  std::shared_ptr<State> state_;
+};
+
+#endif  // S21_THREAD_POOL
@@ -0,0 +1,153 @@
+#include "s21_vector.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "s21_kernels.h"
+#include "s21_thread_pool.h"
+
+/// @brief Нулевой вектор длины size
+S21Vector::S21Vector(std::int64_t size) {
+  if (size < 0)
+    throw std::length_error("размер вектора не может быть отрицательным");
+  data_.assign(size, 0.0);
+}
+
+S21Vector::S21Vector(std::initializer_list<double> values) : data_(values) {}
+
+/// @brief Вектор из матрицы-столбца n x 1 или матрицы-строки 1 x n
+S21Vector::S21Vector(const S21Matrix& matrix) {
+  if (matrix.cols_ != 1 && matrix.rows_ != 1)
+    throw std::length_error("матрица не является вектором");
+  if (matrix.rows_ == 1) {
+    data_.assign(matrix.Row(0), matrix.Row(0) + matrix.cols_);
+  } else {
+    data_.resize(matrix.rows_);
+    for (std::int64_t i = 0; i < matrix.rows_; ++i)
+      data_[i] = matrix.Row(i)[0];
+  }
+}
+
+std::int64_t S21Vector::GetSize() const noexcept {
+  return static_cast<std::int64_t>(data_.size());
+}
+
+/// @brief Меняет длину вектора, новые элементы заполняются нулями
+void S21Vector::SetSize(std::int64_t size) {
+  if (size < 0)
+    throw std::length_error("размер вектора не может быть отрицательным");
+  data_.resize(size, 0.0);
+}
+
+double S21Vector::operator()(std::int64_t i) const {
+  if (i < 0 || i >= GetSize())
+    throw std::length_error("индекс за пределами вектора");
+  return data_[i];
+}
+
+double& S21Vector::operator()(std::int64_t i) {
+  if (i < 0 || i >= GetSize())
+    throw std::length_error("индекс за пределами вектора");
+  return data_[i];
+}
+
+/// @brief Матрица-столбец n x 1
+S21Matrix S21Vector::ToMatrix() const {
+  S21Matrix result(GetSize(), 1);
+  for (std::int64_t i = 0; i < GetSize(); ++i) result.Row(i)[0] = data_[i];
+  return result;
+}
+
+/// @brief Скалярное произведение. Частичные суммы кусков складываются в
+/// фиксированном порядке
+double S21Vector::Dot(const S21Vector& other) const {
+  CheckSize(other);
+  std::int64_t chunk = S21ThreadPool::ChunkLength(1);
+  std::vector<double> partial((GetSize() + chunk - 1) / chunk, 0.0);
+  S21Matrix::ForRows(GetSize(), 1, [&](std::int64_t from, std::int64_t to) {
+    partial[from / chunk] = s21_kernels::Dot(to - from, data_.data() + from,
+                                             other.data_.data() + from);
+  });
+  double sum = 0;
+  for (double value : partial) sum += value;
+  return sum;
+}
+
+/// @brief Евклидова норма
+double S21Vector::Norm() const { return std::sqrt(Dot(*this)); }
+
+/// @brief this = this + alpha * x
+void S21Vector::Axpy(double alpha, const S21Vector& x) {
+  CheckSize(x);
+  S21Matrix::ForRows(GetSize(), 1, [&](std::int64_t from, std::int64_t to) {
+    s21_kernels::Axpy(to - from, alpha, x.data_.data() + from,
+                      data_.data() + from);
+  });
+}
+
+/// @brief this = alpha * this
+void S21Vector::Scal(double alpha) {
+  S21Matrix::ForRows(GetSize(), 1, [&](std::int64_t from, std::int64_t to) {
+    for (std::int64_t i = from; i < to; ++i) data_[i] *= alpha;
+  });
+}
+
+/// @brief this = alpha * op(A) * x + beta * this. Без транспонирования
+/// куски делят строки A, с транспонированием - столбцы, так что каждый
+/// элемент результата считает один поток
+/// @param trans если true, op(A) = A^T
+void S21Vector::Gemv(double alpha, const S21Matrix& a, const S21Vector& x,
+                     double beta, bool trans) {
+  a.CheckMatrix(a);
+  std::int64_t m = trans ? a.cols_ : a.rows_;
+  std::int64_t n = trans ? a.rows_ : a.cols_;
+  if (x.GetSize() != n)
+    throw std::length_error(
+        "число столбцов матрицы не равно размеру вектора");
+  if (GetSize() != m) throw std::length_error("Разная размерность векторов");
+  if (&x == this) {
+    S21Vector temp(*this);
+    temp.Gemv(alpha, a, x, beta, trans);
+    *this = std::move(temp);
+    return;
+  }
+
+  if (trans) {
+    S21Matrix::ForColumns(n, m, [&](std::int64_t from, std::int64_t to) {
+      s21_kernels::Gemv(n, to - from, alpha, a.matrix_ + from,
+                        a.cols_capacity_, true, x.data_.data(), beta,
+                        data_.data() + from);
+    });
+  } else {
+    S21Matrix::ForRows(m, n, [&](std::int64_t from, std::int64_t to) {
+      s21_kernels::Gemv(to - from, n, alpha, a.Row(from), a.cols_capacity_,
+                        false, x.data_.data(), beta, data_.data() + from);
+    });
+  }
+}
+
+void S21Vector::CheckSize(const S21Vector& other) const {
+  if (GetSize() != other.GetSize())
+    throw std::length_error("Разная размерность векторов");
+}
+
+/// @brief Произведение матрицы на вектор
+S21Vector operator*(const S21Matrix& a, const S21Vector& x) {
+  S21Vector result(a.GetRows64());
+  result.Gemv(1.0, a, x, 0.0);
+  return result;
+}
+
+/// @brief Обновление ранга 1 векторами: this = this + alpha * x * y^T.
+/// Большие матрицы делятся по строкам между потоками пула
+void S21Matrix::Ger(double alpha, const S21Vector& x, const S21Vector& y) {
+  if (x.GetSize() != rows_ || y.GetSize() != cols_)
+    throw std::length_error("Разная размерность матриц");
+  CheckMatrix(*this);
+
+  Detach();
+  ForRows(rows_, cols_, [&](std::int64_t from, std::int64_t to) {
+    s21_kernels::Ger(to - from, cols_, alpha, x.Data() + from, 1, y.Data(), 1,
+                     Row(from), cols_capacity_);
+  });
+}
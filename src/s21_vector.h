@@ -0,0 +1,45 @@
+#ifndef S21_VECTOR
+#define S21_VECTOR
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+/// @brief Вектор с непрерывным хранением для произведений матрицы на вектор
+/// (GEMV), скалярных произведений и обновлений ранга 1. Операции делятся на
+/// куски фиксированной длины, большие выполняются в пуле потоков; свёртки
+/// объединяют куски по порядку, поэтому результат не зависит от числа потоков
+/// и порога S21Matrix::SetParallelThreshold
+class S21Vector {
+ public:
+  S21Vector() noexcept = default;
+  explicit S21Vector(std::int64_t size);
+  S21Vector(std::initializer_list<double> values);
+  explicit S21Vector(const S21Matrix& matrix);
+
+  std::int64_t GetSize() const noexcept;
+  void SetSize(std::int64_t size);
+  double operator()(std::int64_t i) const;
+  double& operator()(std::int64_t i);
+  double* Data() noexcept { return data_.data(); }
+  const double* Data() const noexcept { return data_.data(); }
+  S21Matrix ToMatrix() const;
+
+  double Dot(const S21Vector& other) const;
+  double Norm() const;
+  void Axpy(double alpha, const S21Vector& x);
+  void Scal(double alpha);
+  void Gemv(double alpha, const S21Matrix& a, const S21Vector& x, double beta,
+            bool trans = false);
+
+ private:
+  void CheckSize(const S21Vector& other) const;
+
+  std::vector<double> data_;
+};
+
+S21Vector operator*(const S21Matrix& a, const S21Vector& x);
+
+#endif  // S21_VECTOR